@@ -0,0 +1,172 @@
+
+#include "BinaryTrace.hpp"
+#include <climits>
+#include <cstring>
+#include "Varint.hpp"
+
+
+namespace
+{
+    // Reads a zigzag varint that has to fit in an int
+    bool readInt(std::streambuf& in, int& value)
+    {
+        unsigned long long encoded;
+        if (!readVarint(in, encoded))
+            return false;
+        long long decoded = zigzagDecode(encoded);
+        if (decoded < INT_MIN || decoded > INT_MAX)
+            return false;
+        value = static_cast<int>(decoded);
+        return true;
+    }
+
+    bool writeInt(std::streambuf& out, int value)
+    {
+        return writeVarint(out, zigzagEncode(value));
+    }
+}
+
+
+BinaryArrivals::BinaryArrivals(std::istream& in)
+    : in{in.rdbuf()}
+{
+}
+
+bool BinaryArrivals::next(int& customerCount, int& customerTime)
+{
+    int count, delta;
+    if (in == nullptr || !readInt(*in, count) || !readInt(*in, delta))
+        return false;
+    customerCount = count;
+    customerTime = previousTime + delta;
+    previousTime = customerTime;
+    return true;
+}
+
+
+BinaryTraceWriter::BinaryTraceWriter(std::ostream& out, const SimConfig& config, const std::vector<int>& regTimes)
+    : out{out}
+{
+    std::streambuf& buf = *out.rdbuf();
+    bool ok = buf.sputn(BinaryTraceMagic, sizeof BinaryTraceMagic) == sizeof BinaryTraceMagic
+              && writeVarint(buf, BinaryTraceVersion)
+              && writeInt(buf, config.simLen / 60)
+              && writeInt(buf, config.numOfRegs)
+              && writeInt(buf, config.maxLineLen)
+              && buf.sputc(config.lineForm) != std::streambuf::traits_type::eof();
+    for (int regTime : regTimes){
+        ok = ok && writeInt(buf, regTime);
+    }
+    if (!ok)
+        out.setstate(std::ios::badbit);
+}
+
+// Times are stored as the difference from the previous arrival, which is
+// small (and positive) for any sensible trace
+bool BinaryTraceWriter::write(int customerCount, int customerTime)
+{
+    long long delta = (long long)customerTime - previousTime;
+    if (delta < INT_MIN || delta > INT_MAX)
+        return false;
+
+    std::streambuf& buf = *out.rdbuf();
+    if (!writeInt(buf, customerCount) || !writeInt(buf, static_cast<int>(delta))){
+        out.setstate(std::ios::badbit);
+        return false;
+    }
+    previousTime = customerTime;
+    return true;
+}
+
+
+// Determines whether an input is a binary trace, without reading from it
+bool isBinaryTrace(std::istream& in)
+{
+    return in.peek() == BinaryTraceMagic[0];
+}
+
+// Reads the header of a binary trace
+bool readBinarySetup(std::istream& in, SimConfig& config, std::vector<int>& regTimes, Fnv1aHash* hash)
+{
+    std::streambuf& buf = *in.rdbuf();
+    char magic[sizeof BinaryTraceMagic];
+    unsigned long long version;
+    int simLen, lineForm;
+    if (buf.sgetn(magic, sizeof magic) != sizeof magic || std::memcmp(magic, BinaryTraceMagic, sizeof magic) != 0
+        || !readVarint(buf, version) || version != BinaryTraceVersion
+        || !readInt(buf, simLen) || !readInt(buf, config.numOfRegs) || !readInt(buf, config.maxLineLen)
+        || (lineForm = buf.sbumpc()) == std::streambuf::traits_type::eof()){
+        in.setstate(std::ios::failbit);
+        return false;
+    }
+    config.simLen = simLen * 60;
+    config.lineForm = static_cast<char>(lineForm);
+
+    regTimes.assign(config.numOfRegs > 0 ? config.numOfRegs : 0, 0);
+    for (int& regTime : regTimes){
+        if (!readInt(buf, regTime)){
+            in.setstate(std::ios::failbit);
+            return false;
+        }
+    }
+    if (hash != nullptr){
+        hash->addInt(config.simLen);
+        hash->addInt(config.numOfRegs);
+        hash->addInt(config.maxLineLen);
+        hash->addInt(config.lineForm);
+        for (int regTime : regTimes)
+            hash->addInt(regTime);
+    }
+    return true;
+}
+
+// Reads a whole binary trace
+bool readBinaryTrace(std::istream& in, Trace& trace, Fnv1aHash* hash)
+{
+    if (!readBinarySetup(in, trace.config, trace.regTimes, hash))
+        return false;
+
+    BinaryArrivals arrivals(in);
+    Arrival arrival;
+    trace.arrivals.clear();
+    while (arrivals.next(arrival.customerCount, arrival.customerTime)){
+        trace.arrivals.push_back(arrival);
+        if (hash != nullptr){
+            hash->addInt(arrival.customerCount);
+            hash->addInt(arrival.customerTime);
+        }
+    }
+    return true;
+}
+
+// Converts an input one arrival at a time, so that it never has to be
+// held in memory
+bool convertTrace(std::istream& in, std::ostream& out, bool toBinary)
+{
+    SimConfig config;
+    std::vector<int> regTimes;
+    std::unique_ptr<ArrivalSource> arrivals = readInput(in, config, regTimes);
+    if (!arrivals)
+        return false;
+
+    int customerCount, customerTime;
+    if (toBinary){
+        BinaryTraceWriter writer(out, config, regTimes);
+        while (arrivals->next(customerCount, customerTime)){
+            if (!writer.write(customerCount, customerTime))
+                return false;
+        }
+    }
+    else{
+        out << config.simLen / 60 << '\n' << config.numOfRegs << '\n' << config.maxLineLen << '\n'
+            << config.lineForm << '\n';
+        for (int regTime : regTimes){
+            out << regTime << '\n';
+        }
+        while (arrivals->next(customerCount, customerTime)){
+            out << customerCount << ' ' << customerTime << '\n';
+        }
+    }
+    out.flush();
+    return bool(out);
+}
@@ -0,0 +1,81 @@
+// BinaryTrace.hpp
+
+#ifndef BINARYTRACE_HPP
+#define BINARYTRACE_HPP
+
+#include <istream>
+#include <ostream>
+#include <streambuf>
+#include <vector>
+#include "Fnv1aHash.hpp"
+#include "Trace.hpp"
+
+
+// The binary trace format holds the same input as the text format in a
+// fraction of the space, and can be read without tokenizing.  Version 1
+// is laid out as follows, where numbers are zigzag varints (see
+// Varint.hpp) unless said otherwise:
+//
+//   "SSTR"                     4 bytes, which no text input starts with
+//   version                    a plain varint, currently 1
+//   simulation length          in minutes, as in the text format
+//   number of registers
+//   maximum line length
+//   line form                  1 byte, 'S' or 'M'
+//   register process times     one per register
+//   arrivals                   until the end of the input, each the
+//                              customer count, then how long after the
+//                              previous arrival (or 0) it is
+//
+// Like the text format, the arrivals end at the first one that can't be
+// read, so a truncated trace reads as a shorter one.
+const char BinaryTraceMagic[4] = {'S', 'S', 'T', 'R'};
+const unsigned int BinaryTraceVersion = 1;
+
+
+// Reads arrivals from the body of a binary trace
+class BinaryArrivals : public ArrivalSource
+{
+public:
+    explicit BinaryArrivals(std::istream& in);
+    bool next(int& customerCount, int& customerTime) override;
+
+private:
+    std::streambuf* in;
+    int previousTime = 0;
+};
+
+// Writes a binary trace, header first and then one arrival at a time.
+// write() returns false, writing nothing, if the arrival is too far from
+// the previous one for the difference to fit in an int (which a reader
+// would reject), or false if it couldn't be written.
+class BinaryTraceWriter
+{
+public:
+    BinaryTraceWriter(std::ostream& out, const SimConfig& config, const std::vector<int>& regTimes);
+    bool write(int customerCount, int customerTime);
+
+private:
+    std::ostream& out;
+    int previousTime = 0;
+};
+
+
+// Determines whether an input is a binary trace, without reading from it
+bool isBinaryTrace(std::istream& in);
+
+// Reads the header of a binary trace, hashing every value as it's read (as
+// readSetup() would hash it) if given a hash
+bool readBinarySetup(std::istream& in, SimConfig& config, std::vector<int>& regTimes, Fnv1aHash* hash = nullptr);
+
+// Reads a whole binary trace, hashing every value as it's read (as
+// readTrace() would hash it) if given a hash
+bool readBinaryTrace(std::istream& in, Trace& trace, Fnv1aHash* hash = nullptr);
+
+// Converts an input in either format to the binary format, or to the text
+// format with one value (or arrival) per line.  A round trip keeps the
+// trace (every value it reads as), not the text: text that isn't laid out
+// one value (or arrival) per line to begin with comes back in that layout.
+bool convertTrace(std::istream& in, std::ostream& out, bool toBinary);
+
+#endif
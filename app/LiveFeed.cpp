@@ -0,0 +1,322 @@
+
+#include "LiveFeed.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <iomanip>
+#include <thread>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace
+{
+    const std::size_t FeedBufferBytes = 1 << 16;
+
+    // Fills in the address of the Unix domain socket at path, or returns
+    // false if path is too long to be one
+    bool socketAddress(const std::string& path, sockaddr_un& address)
+    {
+        std::memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if (path.empty() || path.size() >= sizeof(address.sun_path)){
+            errno = ENAMETOOLONG;
+            return false;
+        }
+        std::memcpy(address.sun_path, path.c_str(), path.size());
+        return true;
+    }
+
+    // Has epollFd wait for fd to have something to read
+    bool watch(int epollFd, int fd)
+    {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        return epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) == 0;
+    }
+
+    // Opens the live feed at path for writing: the FIFO there, waiting for
+    // it to be opened for reading, or a connection to the socket there
+    int connectFeed(const std::string& path)
+    {
+        struct stat status;
+        if (stat(path.c_str(), &status) == 0 && S_ISFIFO(status.st_mode))
+            return ::open(path.c_str(), O_WRONLY | O_CLOEXEC);
+
+        sockaddr_un address;
+        if (!socketAddress(path, address))
+            return -1;
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0){
+            int error = errno;
+            ::close(fd);
+            errno = error;
+            return -1;
+        }
+        return fd;
+    }
+
+    // Writes all of data to fd, however many writes it takes
+    bool writeAll(int fd, const std::string& data)
+    {
+        std::size_t written = 0;
+        while (written < data.size()){
+            ssize_t n = write(fd, data.data() + written, data.size() - written);
+            if (n < 0 && errno != EINTR)
+                return false;
+            if (n > 0)
+                written += n;
+        }
+        return true;
+    }
+
+    // Returns the latency that a fraction of the latencies (sorted) are at
+    // or under
+    double percentile(const std::vector<double>& sorted, double fraction)
+    {
+        std::size_t index = std::min(sorted.size() - 1, std::size_t(fraction * sorted.size()));
+        return sorted[index];
+    }
+}
+
+
+FeedBuf::~FeedBuf()
+{
+    close();
+}
+
+// Opens the feed without waiting for a feeder, so that the caller can say
+// where to connect before the first read waits for one
+bool FeedBuf::open(const std::string& path)
+{
+    close();
+    buffer.resize(FeedBufferBytes);
+
+    auto fail = [this](){
+        int error = errno;
+        close();
+        errno = error;
+        return false;
+    };
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd < 0)
+        return fail();
+
+    struct stat status;
+    bool exists = stat(path.c_str(), &status) == 0;
+    if (exists && S_ISFIFO(status.st_mode)){
+        fd = ::open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+        if (fd < 0 || !watch(epollFd, fd))
+            return fail();
+        return true;
+    }
+
+    sockaddr_un address;
+    if (!socketAddress(path, address))
+        return fail();
+    if (exists && S_ISSOCK(status.st_mode))
+        unlink(path.c_str());
+    listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd < 0 || bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+        return fail();
+    socketPath = path;
+    if (listen(listenFd, 1) != 0 || !watch(epollFd, listenFd))
+        return fail();
+    return true;
+}
+
+// Reads whatever the feed has, or waits in epoll until it has something.
+// A FIFO is only read once epoll says so, since reading one that no
+// feeder has opened yet looks just like reading one that's been closed.
+FeedBuf::int_type FeedBuf::underflow()
+{
+    if (gptr() < egptr())
+        return traits_type::to_int_type(*gptr());
+
+    while (fd >= 0 || listenFd >= 0){
+        if (fd >= 0 && readable){
+            ssize_t n = read(fd, buffer.data(), buffer.size());
+            if (n > 0){
+                setg(buffer.data(), buffer.data(), buffer.data() + n);
+                return traits_type::to_int_type(buffer[0]);
+            }
+            if (n == 0)
+                break;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                readable = false;
+            else if (errno != EINTR)
+                break;
+            continue;
+        }
+
+        if (fd < 0){
+            int connection = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (connection >= 0){
+                ::close(listenFd);
+                listenFd = -1;
+                unlink(socketPath.c_str());
+                socketPath.clear();
+                fd = connection;
+                if (!watch(epollFd, fd))
+                    break;
+                readable = true;
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                break;
+        }
+
+        epoll_event event;
+        int ready = epoll_wait(epollFd, &event, 1, -1);
+        if (ready < 0 && errno != EINTR)
+            break;
+        if (ready > 0 && fd >= 0)
+            readable = true;
+    }
+    return traits_type::eof();
+}
+
+void FeedBuf::close()
+{
+    if (fd >= 0)
+        ::close(fd);
+    if (listenFd >= 0)
+        ::close(listenFd);
+    if (epollFd >= 0)
+        ::close(epollFd);
+    if (!socketPath.empty())
+        unlink(socketPath.c_str());
+    fd = -1;
+    listenFd = -1;
+    epollFd = -1;
+    readable = false;
+    socketPath.clear();
+    setg(nullptr, nullptr, nullptr);
+}
+
+
+LiveArrivals::LiveArrivals(ArrivalSource& arrivals, const SimStats& stats, std::ostream& log, int statsEvery)
+    : arrivals{arrivals}, stats{stats}, log{log}, statsEvery{statsEvery}, nextStats{statsEvery}
+{
+}
+
+// Being asked for the next arrival means the simulation has caught up with
+// the last one, so its latency ends here, before waiting on the feed; the
+// next one's starts once it's been parsed
+bool LiveArrivals::next(int& customerCount, int& customerTime)
+{
+    caughtUp();
+    if (statsEvery > 0 && lastTime >= nextStats){
+        printRollingStats(lastTime, stats, log);
+        nextStats = (lastTime / statsEvery + 1) * statsEvery;
+    }
+
+    if (!arrivals.next(customerCount, customerTime))
+        return false;
+    lastParsed = FeedClock::now();
+    if (fed.arrivals == 0)
+        firstParsed = lastParsed;
+    fed.arrivals++;
+    fed.customers += customerCount;
+    lastTime = customerTime;
+    timing = true;
+    return true;
+}
+
+void LiveArrivals::finish()
+{
+    caughtUp();
+}
+
+const FeedStats& LiveArrivals::feedStats() const
+{
+    return fed;
+}
+
+// Ends the latency of the last arrival parsed, if it hasn't ended yet
+void LiveArrivals::caughtUp()
+{
+    if (!timing)
+        return;
+    FeedClock::time_point now = FeedClock::now();
+    fed.latencies.push_back(std::chrono::duration<double, std::micro>(now - lastParsed).count());
+    fed.seconds = std::chrono::duration<double>(now - firstParsed).count();
+    timing = false;
+}
+
+
+// Writes the setup right away and then each arrival on schedule, or, when
+// there's no schedule to keep, as few writes as it takes.  The simulation
+// stops reading once its time is up (or at an arrival it can never reach),
+// so arrivals from then on aren't fed, and its hanging up on the feed
+// after the setup is just the end of the feed.
+bool feedTrace(const Trace& trace, const std::string& path, double rate)
+{
+    int fd = connectFeed(path);
+    if (fd < 0)
+        return false;
+    std::signal(SIGPIPE, SIG_IGN);
+
+    const SimConfig& config = trace.config;
+    std::string out = std::to_string(config.simLen / 60) + '\n' + std::to_string(config.numOfRegs) + '\n'
+                      + std::to_string(config.maxLineLen) + '\n' + config.lineForm + '\n';
+    for (int regTime : trace.regTimes){
+        out += std::to_string(regTime) + '\n';
+    }
+    bool setUp = writeAll(fd, out);
+    bool written = setUp;
+    out.clear();
+
+    FeedClock::time_point start = FeedClock::now();
+    for (std::size_t i = 0; written && i < trace.arrivals.size() && trace.arrivals[i].customerTime < config.simLen;
+         i++){
+        if (rate > 0)
+            std::this_thread::sleep_until(start + std::chrono::duration_cast<FeedClock::duration>(
+                                                      std::chrono::duration<double>(i / rate)));
+        out += std::to_string(trace.arrivals[i].customerCount) + ' '
+               + std::to_string(trace.arrivals[i].customerTime) + '\n';
+        if (rate > 0 || out.size() >= FeedBufferBytes){
+            written = writeAll(fd, out);
+            out.clear();
+        }
+    }
+    if (written)
+        written = writeAll(fd, out);
+    bool hungUp = setUp && !written && errno == EPIPE;
+
+    ::close(fd);
+    return written || hungUp;
+}
+
+// Writes the stats of the simulation so far as one line of the log
+void printRollingStats(int timer, const SimStats& stats, std::ostream& log)
+{
+    log << timer << " stats entered " << stats.totalEntered << " exited line " << stats.exitedLine
+        << " exited register " << stats.exitedReg << " avg wait " << std::setprecision(2) << std::fixed
+        << (stats.exitedLine > 0 ? stats.totalWait / (float)stats.exitedLine : 0.0f)
+        << " lost " << stats.totalLost << std::endl;
+}
+
+// Prints the FEED section: the throughput and latencies of a live feed
+void printFeedStats(const FeedStats& fed, std::ostream& out)
+{
+    out << std::endl << "FEED" << std::endl;
+    out << "Arrivals        : " << fed.arrivals << std::endl;
+    out << "Customers       : " << fed.customers << std::endl;
+    out << "Seconds         : " << std::setprecision(3) << std::fixed << fed.seconds << std::endl;
+    out << "Arrivals/Second : " << std::setprecision(0)
+        << (fed.seconds > 0 ? fed.latencies.size() / fed.seconds : 0.0) << std::endl;
+    if (fed.latencies.empty())
+        return;
+
+    std::vector<double> sorted = fed.latencies;
+    std::sort(sorted.begin(), sorted.end());
+    out << "Latency (us)    : (parsed to simulated) p50 " << std::setprecision(1) << percentile(sorted, 0.5)
+        << ", p99 " << percentile(sorted, 0.99) << ", max " << sorted.back() << std::endl;
+}
@@ -0,0 +1,117 @@
+// LiveFeed.hpp
+
+#ifndef LIVEFEED_HPP
+#define LIVEFEED_HPP
+
+#include <chrono>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include "Simulation.hpp"
+#include "Trace.hpp"
+
+
+// A live feed is an input that's still being written while it's simulated,
+// like a point-of-sale system's arrivals: it comes from a FIFO, or from a
+// Unix domain socket that a single feeder connects to, rather than from a
+// finished file.  The input is the same as ever (in either format, see
+// BinaryTrace.hpp), except that a text feed should end every arrival with
+// a newline, so that reading a number never has to wait on the next one.
+using FeedClock = std::chrono::steady_clock;
+
+// Reads a live feed without ever blocking in read(): the feed is
+// non-blocking, and when it has nothing more to read yet, underflow()
+// waits in epoll until it does, so that "no arrival yet" (waiting) is told
+// apart from the end of the input (the feeder closing its end).  An
+// std::istream reading from one works like any other.
+class FeedBuf : public std::streambuf
+{
+public:
+    FeedBuf() = default;
+    ~FeedBuf() override;
+
+    FeedBuf(const FeedBuf&) = delete;
+    FeedBuf& operator=(const FeedBuf&) = delete;
+
+    // Opens the FIFO at path if there is one, or else creates a Unix domain
+    // socket there (replacing any socket that was already there) and
+    // listens on it.  The first read waits for a feeder to connect (or
+    // open the FIFO).  Returns false, with errno set, if it can't.
+    bool open(const std::string& path);
+
+protected:
+    int_type underflow() override;
+
+private:
+    void close();
+
+    int epollFd = -1;
+    int listenFd = -1;
+    int fd = -1;
+    bool readable = false;
+    std::string socketPath;
+    std::vector<char> buffer;
+};
+
+// What happened to the arrivals of a live feed: how many came, how long
+// they took from the first one being parsed to the last one being
+// simulated, and each one's latency (in microseconds), from being parsed
+// off the feed to the simulation having run and logged its tick.  An
+// arrival is parsed when the simulation asks for it, so time it spent in
+// the feed's buffer waiting for the simulation to get to it doesn't count.
+struct FeedStats
+{
+    long long arrivals = 0;
+    long long customers = 0;
+    double seconds = 0;
+    std::vector<double> latencies;
+};
+
+// Passes on the arrivals of a live feed, timing how long the simulation
+// takes to catch up with each one.  A simulation only asks for the next
+// arrival once it's placed the last one and run and logged that tick,
+// which is what drives its clock: it never runs ahead of the feed.  That's
+// also when the stats are up to date, so every statsEvery seconds of
+// simulation (if statsEvery > 0) the stats so far are written to the log.
+// A simulation that ends without asking for another arrival should be
+// followed by finish(), which ends the last one's latency.
+class LiveArrivals : public ArrivalSource
+{
+public:
+    LiveArrivals(ArrivalSource& arrivals, const SimStats& stats, std::ostream& log, int statsEvery);
+    bool next(int& customerCount, int& customerTime) override;
+    void finish();
+
+    const FeedStats& feedStats() const;
+
+private:
+    void caughtUp();
+
+    ArrivalSource& arrivals;
+    const SimStats& stats;
+    std::ostream& log;
+    int statsEvery;
+    int nextStats;
+    int lastTime = -1;
+    bool timing = false;
+    FeedClock::time_point firstParsed;
+    FeedClock::time_point lastParsed;
+    FeedStats fed;
+};
+
+
+// Writes a trace to the live feed at path (a FIFO, or a Unix domain socket
+// that's being listened on) in the text format, at rate arrivals per
+// second of real time, or as fast as it can if rate isn't positive.  This
+// stands in for a real feed when measuring a live simulation.  Arrivals at
+// or after the end of the simulation aren't fed, since it never reads them.
+bool feedTrace(const Trace& trace, const std::string& path, double rate);
+
+// Writes the stats of the simulation so far as one line of the log
+void printRollingStats(int timer, const SimStats& stats, std::ostream& log);
+
+// Prints the FEED section: the throughput and latencies of a live feed
+void printFeedStats(const FeedStats& fed, std::ostream& out);
+
+#endif
@@ -0,0 +1,116 @@
+
+#include "Optimizer.hpp"
+#include <algorithm>
+#include <memory>
+#include "Queue.hpp"
+#include "WorkerPool.hpp"
+
+
+namespace
+{
+    // Simulates the trace with its first numOfRegs registers, without a
+    // log, stopping as soon as the target is certain to be missed
+    StaffingRun runStaffing(const Trace& trace, const StaffingTarget& target, int numOfRegs)
+    {
+        SimConfig config = trace.config;
+        config.numOfRegs = numOfRegs;
+        std::vector<int> regTimes(trace.regTimes.begin(), trace.regTimes.begin() + numOfRegs);
+        std::unique_ptr<int[][2]> regTime{new int[numOfRegs][2]};
+        makeRegTime(regTime.get(), regTimes);
+
+        SimLimits limits{target.maxLost, target.maxAvgWait, traceCustomers(trace)};
+        TraceArrivals arrivals{trace};
+        std::ostream noLog{nullptr};
+
+        StaffingRun run{numOfRegs, false, false, SimStats{}};
+        run.finished = simulate<Queue<int>>(config, regTime.get(), arrivals, noLog, run.stats, 1, &limits, nullptr);
+
+        double avgWait = run.stats.exitedLine > 0 ? run.stats.totalWait / double(run.stats.exitedLine) : 0.0;
+        run.meetsTarget = run.finished && run.stats.totalLost <= target.maxLost && avgWait <= target.maxAvgWait;
+        return run;
+    }
+}
+
+
+// Searches for the fewest registers that meet the target.  Everything
+// from hi up is known to meet it and everything below lo is known not to;
+// each round tries up to one candidate per thread, evenly spread over
+// [lo, hi), and narrows the range to fit.
+std::vector<StaffingRun> optimizeStaffing(const Trace& trace, const StaffingTarget& target, int numThreads)
+{
+    std::vector<StaffingRun> runs;
+    int lo = 1;
+    int hi = trace.config.numOfRegs;
+    if (hi < 1)
+        return runs;
+
+    WorkerPool pool(numThreads);
+    runs.push_back(runStaffing(trace, target, hi));
+    if (!runs.back().meetsTarget)
+        return runs;
+
+    while (lo < hi){
+        std::vector<int> candidates;
+        for (unsigned int j = 1; j <= pool.size(); j++){
+            int candidate = lo + (hi - lo) * j / (pool.size() + 1);
+            if (candidates.empty() || candidate != candidates.back())
+                candidates.push_back(candidate);
+        }
+
+        std::vector<StaffingRun> round(candidates.size());
+        pool.run([&](unsigned int w){
+            if (w < candidates.size())
+                round[w] = runStaffing(trace, target, candidates[w]);
+        });
+
+        int newLo = lo;
+        for (const StaffingRun& run : round){
+            if (run.meetsTarget)
+                hi = std::min(hi, run.numOfRegs);
+            else
+                newLo = std::max(newLo, run.numOfRegs + 1);
+        }
+        lo = std::min(newLo, hi);
+        runs.insert(runs.end(), round.begin(), round.end());
+    }
+
+    std::sort(runs.begin(), runs.end(), [](const StaffingRun& a, const StaffingRun& b){
+        return a.numOfRegs < b.numOfRegs;
+    });
+    return runs;
+}
+
+// Returns the run with the fewest registers that meets the target, or
+// nullptr if there isn't one
+const StaffingRun* bestStaffing(const std::vector<StaffingRun>& runs)
+{
+    for (const StaffingRun& run : runs){
+        if (run.meetsTarget)
+            return &run;
+    }
+    return nullptr;
+}
+
+// Prints the runs that optimizeStaffing() made, then the best one's STATS
+void printStaffing(const std::vector<StaffingRun>& runs, std::ostream& out)
+{
+    out << "OPTIMIZE" << std::endl;
+    for (const StaffingRun& run : runs){
+        out << run.numOfRegs << " registers ";
+        if (run.meetsTarget)
+            out << "meet target" << std::endl;
+        else if (run.finished)
+            out << "miss target" << std::endl;
+        else
+            out << "miss target (stopped early)" << std::endl;
+    }
+
+    const StaffingRun* best = bestStaffing(runs);
+    if (best == nullptr){
+        out << std::endl << "Registers       : none" << std::endl;
+    }
+    else{
+        out << std::endl << "Registers       : " << best->numOfRegs << std::endl;
+        printStats(best->stats, out);
+    }
+}
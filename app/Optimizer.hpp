@@ -0,0 +1,43 @@
+// Optimizer.hpp
+
+#ifndef OPTIMIZER_HPP
+#define OPTIMIZER_HPP
+
+#include <vector>
+#include "Simulation.hpp"
+#include "Trace.hpp"
+
+
+// The limits that a store has to stay within to be staffed well enough
+struct StaffingTarget
+{
+    int maxLost;
+    double maxAvgWait;
+};
+
+// The outcome of simulating a trace with only its first numOfRegs registers
+// open.  A run that was certain to miss the target was stopped early, so
+// its stats only cover the part of the simulation that was run.
+struct StaffingRun
+{
+    int numOfRegs;
+    bool finished;
+    bool meetsTarget;
+    SimStats stats;
+};
+
+// Searches for the fewest registers that meet the target, trying only the
+// first n of the trace's registers for each n, and assuming that opening
+// another register never makes things worse.  Up to numThreads candidate
+// counts are simulated at once, splitting the remaining range between
+// them.  Returns every run that was made, ordered by number of registers.
+std::vector<StaffingRun> optimizeStaffing(const Trace& trace, const StaffingTarget& target, int numThreads);
+
+// Returns the run with the fewest registers that meets the target, or
+// nullptr if there isn't one
+const StaffingRun* bestStaffing(const std::vector<StaffingRun>& runs);
+
+// Prints the runs that optimizeStaffing() made, then the best one's STATS
+void printStaffing(const std::vector<StaffingRun>& runs, std::ostream& out);
+
+#endif
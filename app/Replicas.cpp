@@ -0,0 +1,313 @@
+
+#include "Replicas.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+
+namespace
+{
+    // A vector of LaneWidth ints, one lane per replica.  With AVX2 it's a
+    // single register; without it, the compiler splits every operation
+    // into two 16-byte halves, which SSE2 (and so every x86-64) has.
+    // Comparisons give -1 in the lanes where they hold and 0 elsewhere.
+    // It's only aligned as an int, so that it can be laid over any
+    // LaneWidth ints in a row.
+    const std::size_t LaneWidth = 8;
+    typedef int LaneVector __attribute__((vector_size(LaneWidth * sizeof(int)), aligned(alignof(int))));
+
+    LaneVector& lanesAt(int* p)
+    {
+        return *reinterpret_cast<LaneVector*>(p);
+    }
+
+    const LaneVector& lanesAt(const int* p)
+    {
+        return *reinterpret_cast<const LaneVector*>(p);
+    }
+
+    // The state of every replica, stored structure-of-arrays: the entry
+    // for register (or line) i in replica k is at i * lanes + k, so that
+    // each register's entries for all replicas are next to each other.
+    // lanes is the number of replicas rounded up to whole vectors; the
+    // lanes past the last replica never get any customers.
+    // Lines keep their length and the arrival time of their front customer
+    // that way, which is all that advancing a register needs; the rest of
+    // each line's arrival times are in a queue of its own.
+    struct ReplicaBatch
+    {
+        // A circular buffer of arrival times that starts out small and
+        // doubles (up to maxLineLen) only when it fills up itself, so that
+        // memory follows how long each line actually gets rather than the
+        // longest line in any replica
+        struct LaneQueue
+        {
+            std::vector<int> slots;
+            std::size_t head = 0;
+        };
+
+        std::size_t lanes;
+        std::vector<int> elapsed;
+        std::vector<int> length;
+        std::vector<int> front;
+        std::vector<LaneQueue> queues;
+        std::vector<int> taken;
+
+        std::vector<int> totalLost;
+        std::vector<int> totalEntered;
+        std::vector<int> totalWait;
+        std::vector<int> exitedLine;
+        std::vector<int> exitedReg;
+
+        ReplicaBatch(std::size_t numOfRegs, std::size_t numOfLines, std::size_t numOfReplicas);
+        void enqueue(std::size_t queue, int timer, int maxLineLen);
+        void advanceReg(std::size_t reg, int procTime, std::size_t lineQueues, int timer);
+        void dequeueTaken(std::size_t lineQueues);
+    };
+
+    ReplicaBatch::ReplicaBatch(std::size_t numOfRegs, std::size_t numOfLines, std::size_t numOfReplicas)
+        : lanes{(numOfReplicas + LaneWidth - 1) / LaneWidth * LaneWidth}, elapsed(numOfRegs * lanes, 0), length(numOfLines * lanes, 0),
+          front(numOfLines * lanes, 0), queues(numOfLines * lanes), taken(lanes, 0), totalLost(lanes, 0),
+          totalEntered(lanes, 0), totalWait(lanes, 0), exitedLine(lanes, 0), exitedReg(lanes, 0)
+    {
+    }
+
+    void ReplicaBatch::enqueue(std::size_t queue, int timer, int maxLineLen)
+    {
+        LaneQueue& lane = queues[queue];
+        std::size_t count = length[queue];
+        std::size_t capacity = lane.slots.size();
+        if (count == capacity){
+            std::size_t newCapacity = std::min(std::max<std::size_t>(capacity * 2, 4),
+                                               std::max<std::size_t>(maxLineLen, 1));
+            std::vector<int> newSlots(newCapacity, 0);
+            for (std::size_t j = 0; j < count; j++){
+                newSlots[j] = lane.slots[(lane.head + j) % capacity];
+            }
+            lane.slots.swap(newSlots);
+            lane.head = 0;
+            capacity = newCapacity;
+        }
+
+        lane.slots[(lane.head + count) % capacity] = timer;
+        if (count == 0)
+            front[queue] = timer;
+        length[queue]++;
+    }
+
+    // Advances a register in every replica at once, as multiLine() and
+    // singleLine() do one replica at a time: a customer whose time is up
+    // exits, then an idle register takes the next customer from its line
+    // (whose queues for the replicas start at lineQueues), and a busy one
+    // carries on.  This is written LaneWidth lanes at a time with vector
+    // types, every step a mask rather than a branch, over arrays that are
+    // contiguous over the lanes; which lanes took a customer is left in
+    // taken for dequeueTaken() to act on.
+    void ReplicaBatch::advanceReg(std::size_t reg, int procTime, std::size_t lineQueues, int timer)
+    {
+        int* regElapsed = elapsed.data() + reg * lanes;
+        const int* lineLength = length.data() + lineQueues;
+        const int* lineFront = front.data() + lineQueues;
+        const LaneVector zero = LaneVector{}, five = zero + 5, proc = zero + procTime, now = zero + timer;
+
+        for (std::size_t k = 0; k < lanes; k += LaneWidth){
+            LaneVector e = lanesAt(regElapsed + k);
+            LaneVector exited = e == proc;
+            lanesAt(&exitedReg[k]) -= exited;
+            e &= ~exited;
+
+            LaneVector take = (e == zero) & (lanesAt(lineLength + k) > zero);
+            LaneVector wait = now - lanesAt(lineFront + k);
+            lanesAt(&totalWait[k]) += wait & take;
+            lanesAt(&exitedLine[k]) -= take;
+            lanesAt(regElapsed + k) = (five & take) | ((e + five) & (e > zero) & ~take);
+            lanesAt(&taken[k]) = zero - take;
+        }
+    }
+
+    // Takes the front customer off the lines of the lanes that advanceReg()
+    // said took one, bringing their fronts up from their queues
+    void ReplicaBatch::dequeueTaken(std::size_t lineQueues)
+    {
+        for (std::size_t k = 0; k < lanes; k++){
+            if (!taken[k])
+                continue;
+            std::size_t queue = lineQueues + k;
+            LaneQueue& lane = queues[queue];
+            lane.head = lane.head + 1 == lane.slots.size() ? 0 : lane.head + 1;
+            if (--length[queue] > 0)
+                front[queue] = lane.slots[lane.head];
+        }
+    }
+
+    // Two-sided 95% quantiles of Student's t distribution for 1 to 30
+    // degrees of freedom; past that the normal distribution's is close
+    // enough
+    const double TQuantiles[] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+    };
+
+    template <typename Stat>
+    Estimate estimate(const std::vector<SimStats>& replicas, Stat stat)
+    {
+        std::size_t n = replicas.size();
+        double sum = 0;
+        for (const SimStats& replica : replicas)
+            sum += stat(replica);
+        double mean = n > 0 ? sum / n : 0.0;
+        if (n < 2)
+            return Estimate{mean, 0.0};
+
+        double squares = 0;
+        for (const SimStats& replica : replicas)
+            squares += (stat(replica) - mean) * (stat(replica) - mean);
+        double t = n - 1 <= 30 ? TQuantiles[n - 2] : 1.96;
+        return Estimate{mean, t * std::sqrt(squares / (n - 1) / n)};
+    }
+
+    void printEstimate(std::ostream& out, const char* label, const Estimate& estimate)
+    {
+        out << label << std::setprecision(2) << std::fixed << estimate.mean << " +- " << estimate.halfWidth
+            << std::endl;
+    }
+}
+
+
+// Runs every replica's ticks together.  In multi-line mode, register i's
+// line is line i; in single-line mode every register shares line 0.
+std::vector<SimStats> simulateReplicas(const SimConfig& config, const std::vector<int>& regTimes,
+                                       const std::vector<ArrivalSource*>& arrivals)
+{
+    std::size_t numOfReplicas = arrivals.size();
+    int numOfRegs = config.numOfRegs;
+    bool multi = config.lineForm == 'M';
+    int numOfLines = multi ? numOfRegs : 1;
+    ReplicaBatch batch(numOfRegs, numOfLines, numOfReplicas);
+    std::size_t lanes = batch.lanes;
+
+    std::vector<int> customerCount(numOfReplicas, 0), customerTime(numOfReplicas, -1);
+    for (std::size_t k = 0; k < numOfReplicas; k++){
+        arrivals[k]->next(customerCount[k], customerTime[k]);
+    }
+
+    for (int timer = 0; timer < config.simLen; timer += 5){
+        for (std::size_t k = 0; k < numOfReplicas; k++){
+            if (customerTime[k] != timer)
+                continue;
+
+            for (int c = 0; c < customerCount[k]; c++){
+                int line = 0;
+                if (multi){
+                    // The shortest line that isn't full, as shortLine() picks it
+                    int lineSize = config.maxLineLen;
+                    line = numOfRegs;
+                    for (int i = 0; i < numOfRegs; i++){
+                        if (batch.length[i * lanes + k] < lineSize){
+                            lineSize = batch.length[i * lanes + k];
+                            line = i;
+                        }
+                    }
+                }
+                else if (batch.length[k] >= config.maxLineLen){
+                    line = numOfLines;
+                }
+
+                if (line == numOfLines){
+                    batch.totalLost[k]++;
+                }
+                else{
+                    batch.enqueue(line * lanes + k, timer, config.maxLineLen);
+                    batch.totalEntered[k]++;
+                }
+            }
+            if (!arrivals[k]->next(customerCount[k], customerTime[k]))
+                customerTime[k] = -1;
+        }
+
+        for (int i = 0; i < numOfRegs; i++){
+            std::size_t lineQueues = multi ? i * lanes : 0;
+            batch.advanceReg(i, regTimes[i], lineQueues, timer);
+            batch.dequeueTaken(lineQueues);
+        }
+    }
+
+    std::vector<SimStats> replicas(numOfReplicas);
+    for (std::size_t k = 0; k < numOfReplicas; k++){
+        SimStats& stats = replicas[k];
+        stats.totalLost = batch.totalLost[k];
+        stats.totalEntered = batch.totalEntered[k];
+        stats.totalWait = batch.totalWait[k];
+        stats.exitedLine = batch.exitedLine[k];
+        stats.exitedReg = batch.exitedReg[k];
+        for (int line = 0; line < numOfLines; line++){
+            stats.leftInLine += batch.length[line * lanes + k];
+        }
+        for (int i = 0; i < numOfRegs; i++){
+            stats.leftInReg += batch.elapsed[i * lanes + k] > 0;
+        }
+    }
+    return replicas;
+}
+
+
+ResampledArrivals::ResampledArrivals(const Trace& trace, unsigned long long seed, unsigned long long replica)
+    : arrivals{trace.arrivals}
+{
+    // seed_seq only takes 32 bits of each value
+    std::seed_seq seq{seed & 0xffffffffu, seed >> 32, replica & 0xffffffffu, replica >> 32};
+    random.seed(seq);
+}
+
+bool ResampledArrivals::next(int& customerCount, int& customerTime)
+{
+    if (nextArrival == arrivals.size())
+        return false;
+    const Arrival& arrival = arrivals[nextArrival++];
+    customerCount = 0;
+    if (arrival.customerCount > 0){
+        std::poisson_distribution<int> count(arrival.customerCount);
+        customerCount = count(random);
+    }
+    customerTime = arrival.customerTime;
+    return true;
+}
+
+
+ReplicaSummary summarizeReplicas(const std::vector<SimStats>& replicas)
+{
+    ReplicaSummary summary;
+    summary.entered = estimate(replicas, [](const SimStats& s){ return double(s.totalEntered); });
+    summary.exitedLine = estimate(replicas, [](const SimStats& s){ return double(s.exitedLine); });
+    summary.exitedReg = estimate(replicas, [](const SimStats& s){ return double(s.exitedReg); });
+    summary.avgWait = estimate(replicas, [](const SimStats& s){
+        return s.exitedLine > 0 ? s.totalWait / double(s.exitedLine) : 0.0;
+    });
+    summary.leftInLine = estimate(replicas, [](const SimStats& s){ return double(s.leftInLine); });
+    summary.leftInReg = estimate(replicas, [](const SimStats& s){ return double(s.leftInReg); });
+    summary.lost = estimate(replicas, [](const SimStats& s){ return double(s.totalLost); });
+    return summary;
+}
+
+// Prints a line of stats for every replica, then the confidence intervals
+void printReplicas(const std::vector<SimStats>& replicas, const ReplicaSummary& summary, std::ostream& out)
+{
+    out << "REPLICAS" << std::endl;
+    for (std::size_t k = 0; k < replicas.size(); k++){
+        const SimStats& stats = replicas[k];
+        out << k + 1 << ": entered " << stats.totalEntered << ", exited line " << stats.exitedLine
+            << ", exited register " << stats.exitedReg << ", avg wait " << std::setprecision(2) << std::fixed
+            << stats.totalWait/(float)stats.exitedLine << ", left in line " << stats.leftInLine
+            << ", left in register " << stats.leftInReg << ", lost " << stats.totalLost << std::endl;
+    }
+
+    out << std::endl << "STATS (95% confidence)" << std::endl;
+    printEstimate(out, "Entered Line    : ", summary.entered);
+    printEstimate(out, "Exited Line     : ", summary.exitedLine);
+    printEstimate(out, "Exited Register : ", summary.exitedReg);
+    printEstimate(out, "Avg Wait Time   : ", summary.avgWait);
+    printEstimate(out, "Left In Line    : ", summary.leftInLine);
+    printEstimate(out, "Left In Register: ", summary.leftInReg);
+    printEstimate(out, "Lost            : ", summary.lost);
+}
@@ -0,0 +1,76 @@
+// Replicas.hpp
+
+#ifndef REPLICAS_HPP
+#define REPLICAS_HPP
+
+#include <ostream>
+#include <random>
+#include <vector>
+#include "Simulation.hpp"
+#include "Trace.hpp"
+
+
+// Replicas are simulations that share a setup (the configuration and the
+// registers' process times) but each have arrivals of their own, like the
+// Monte-Carlo runs that confidence intervals are built from.
+//
+// simulateReplicas() runs one replica per arrival source, all of them in
+// lockstep: every tick, each register is advanced in every replica at once,
+// with the replicas as the lanes of a loop that has no branches in it, so
+// that the compiler can turn it into vector instructions.  To keep the
+// lanes next to each other, everything the loop touches is stored
+// structure-of-arrays: a register's elapsed times for all replicas in a
+// row, and likewise for each line's length and front arrival time.  The
+// rest of a line is in a queue per replica, which grows on its own and is
+// only touched (one lane at a time) by the lanes that took a customer.
+// Arrivals differ between replicas, so they're handled one replica at a
+// time.
+//
+// Each replica's stats are the same as simulate() would give for its
+// arrivals; there's no log.
+std::vector<SimStats> simulateReplicas(const SimConfig& config, const std::vector<int>& regTimes,
+                                       const std::vector<ArrivalSource*>& arrivals);
+
+// Arrivals at the same times as a trace's, but with the number of
+// customers in each drawn at random (from a Poisson distribution whose
+// mean is the trace's count), so that replicas built from one trace differ
+// only in their randomness
+class ResampledArrivals : public ArrivalSource
+{
+public:
+    ResampledArrivals(const Trace& trace, unsigned long long seed, unsigned long long replica);
+    bool next(int& customerCount, int& customerTime) override;
+
+private:
+    const std::vector<Arrival>& arrivals;
+    std::size_t nextArrival = 0;
+    std::mt19937_64 random;
+};
+
+// The mean of a stat over the replicas, and the half-width of its 95%
+// confidence interval (0 if there's only one replica)
+struct Estimate
+{
+    double mean;
+    double halfWidth;
+};
+
+// The confidence intervals of every stat in STATS.  A replica in which
+// nobody exited a line counts as having an average wait of 0.
+struct ReplicaSummary
+{
+    Estimate entered;
+    Estimate exitedLine;
+    Estimate exitedReg;
+    Estimate avgWait;
+    Estimate leftInLine;
+    Estimate leftInReg;
+    Estimate lost;
+};
+
+ReplicaSummary summarizeReplicas(const std::vector<SimStats>& replicas);
+
+// Prints a line of stats for every replica, then the confidence intervals
+void printReplicas(const std::vector<SimStats>& replicas, const ReplicaSummary& summary, std::ostream& out);
+
+#endif
@@ -0,0 +1,182 @@
+
+#include "ResultCache.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <system_error>
+#include <vector>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    const char* const EntryMagic = "StoreSim-result 2";
+    const char* const EntryExtension = ".entry";
+    const char* const TempPrefix = ".tmp-";
+
+    // A temporary file that's this old was left behind by a writer that
+    // never finished, and can be removed
+    const auto StaleTemp = std::chrono::hours(1);
+
+    struct EntryFile
+    {
+        fs::file_time_type time;
+        unsigned long long size;
+        fs::path path;
+    };
+}
+
+
+ResultCache::ResultCache(const std::string& dir, unsigned long long maxBytes)
+    : dir{dir}, maxBytes{maxBytes}
+{
+}
+
+// Reads the entry for the input if there is one.  An entry starts with a
+// line identifying the format, then a line with the hash, configuration
+// (including the jockeying margin) and number of arrivals, a line with the stats, and a line with the
+// length of the log (or -1 if there's no log), followed by the log itself.
+bool ResultCache::load(const Trace& trace, Fnv1aHash::Value traceHash, bool needLog, CachedResult& result)
+{
+    fs::path path = entryPath(traceHash);
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        return false;
+
+    std::string magic;
+    std::getline(in, magic);
+    if (magic != EntryMagic)
+        return false;
+
+    Fnv1aHash::Value hash;
+    SimConfig config;
+    std::size_t arrivalCount;
+    if (!(in >> std::hex >> hash >> std::dec >> config.simLen >> config.numOfRegs >> config.maxLineLen
+             >> config.lineForm >> config.jockeyMargin >> arrivalCount))
+        return false;
+    if (hash != traceHash || config.simLen != trace.config.simLen || config.numOfRegs != trace.config.numOfRegs
+        || config.maxLineLen != trace.config.maxLineLen || config.lineForm != trace.config.lineForm
+        || config.jockeyMargin != trace.config.jockeyMargin || arrivalCount != trace.arrivals.size())
+        return false;
+
+    SimStats& stats = result.stats;
+    long long logLength;
+    if (!(in >> stats.totalLost >> stats.totalEntered >> stats.totalWait >> stats.exitedLine
+             >> stats.exitedReg >> stats.leftInLine >> stats.leftInReg >> logLength))
+        return false;
+
+    result.hasLog = logLength >= 0;
+    result.log.clear();
+    if (needLog && !result.hasLog)
+        return false;
+    if (needLog){
+        in.get();
+        result.log.resize(logLength);
+        if (!in.read(&result.log[0], logLength))
+            return false;
+    }
+
+    // Hits count as uses for eviction
+    std::error_code error;
+    fs::last_write_time(path, fs::file_time_type::clock::now(), error);
+    return true;
+}
+
+// Writes the entry under a name no other process uses, then renames it
+// over the real one, which replaces it in one step
+void ResultCache::store(const Trace& trace, Fnv1aHash::Value traceHash, const CachedResult& result)
+{
+    std::error_code error;
+    fs::create_directories(dir, error);
+
+    fs::path path = entryPath(traceHash);
+    std::ostringstream tempName;
+    tempName << TempPrefix << getpid() << '-' << path.filename().string();
+    fs::path tempPath = dir / tempName.str();
+
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        const SimConfig& config = trace.config;
+        const SimStats& stats = result.stats;
+        out << EntryMagic << '\n';
+        out << std::hex << traceHash << std::dec << ' ' << config.simLen << ' ' << config.numOfRegs << ' '
+            << config.maxLineLen << ' ' << config.lineForm << ' ' << config.jockeyMargin << ' '
+            << trace.arrivals.size() << '\n';
+        out << stats.totalLost << ' ' << stats.totalEntered << ' ' << stats.totalWait << ' '
+            << stats.exitedLine << ' ' << stats.exitedReg << ' ' << stats.leftInLine << ' '
+            << stats.leftInReg << '\n';
+        if (result.hasLog)
+            out << result.log.size() << '\n' << result.log;
+        else
+            out << -1 << '\n';
+        out.close();
+        if (!out){
+            fs::remove(tempPath, error);
+            return;
+        }
+    }
+
+    fs::rename(tempPath, path, error);
+    if (error){
+        fs::remove(tempPath, error);
+        return;
+    }
+    evict();
+}
+
+fs::path ResultCache::entryPath(Fnv1aHash::Value traceHash) const
+{
+    std::ostringstream name;
+    name << std::hex;
+    name.width(16);
+    name.fill('0');
+    name << traceHash << EntryExtension;
+    return dir / name.str();
+}
+
+// Removes the least recently used entries until the rest fit in maxBytes,
+// along with temporary files that were abandoned.  Other processes may be
+// evicting at the same time, so files can disappear from under this; that
+// only means there's less to do.
+void ResultCache::evict()
+{
+    std::error_code error;
+    std::vector<EntryFile> entries;
+    unsigned long long totalBytes = 0;
+    fs::file_time_type now = fs::file_time_type::clock::now();
+
+    for (fs::directory_iterator it(dir, error), end; !error && it != end; it.increment(error)){
+        const fs::path& path = it->path();
+        std::string name = path.filename().string();
+        std::error_code fileError;
+        fs::file_time_type time = fs::last_write_time(path, fileError);
+        unsigned long long size = fs::file_size(path, fileError);
+        if (fileError)
+            continue;
+
+        if (name.compare(0, std::strlen(TempPrefix), TempPrefix) == 0){
+            if (now - time > StaleTemp)
+                fs::remove(path, fileError);
+        }
+        else if (path.extension() == EntryExtension){
+            entries.push_back(EntryFile{time, size, path});
+            totalBytes += size;
+        }
+    }
+
+    if (totalBytes <= maxBytes)
+        return;
+
+    std::sort(entries.begin(), entries.end(), [](const EntryFile& a, const EntryFile& b){
+        return a.time < b.time;
+    });
+    for (const EntryFile& entry : entries){
+        if (totalBytes <= maxBytes)
+            break;
+        fs::remove(entry.path, error);
+        totalBytes -= entry.size;
+    }
+}
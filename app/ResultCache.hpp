@@ -0,0 +1,57 @@
+// ResultCache.hpp
+
+#ifndef RESULTCACHE_HPP
+#define RESULTCACHE_HPP
+
+#include <filesystem>
+#include <string>
+#include "Fnv1aHash.hpp"
+#include "Simulation.hpp"
+#include "Trace.hpp"
+
+
+// What a finished simulation produced, as the cache keeps it.  The log is
+// everything the simulation wrote to its log (so without the "LOG" and
+// "0 start" lines that come before it), and is only kept if hasLog is set.
+struct CachedResult
+{
+    SimStats stats;
+    bool hasLog = false;
+    std::string log;
+};
+
+// Keeps the results of simulations in a directory, one file per input,
+// named after the hash of the input (see readTrace()).  Each file also
+// holds the input's configuration and number of arrivals, which have to
+// match for a file to count as a hit, so that a hash collision between
+// two different-looking inputs doesn't return the wrong results.
+//
+// Several processes can share a directory: entries are written to a
+// temporary file and renamed into place, so a reader only ever sees whole
+// entries, and a file that's removed while it's being read stays readable
+// until it's closed.  Once the entries take up more than maxBytes, the
+// ones that were least recently stored or hit are removed.
+class ResultCache
+{
+public:
+    ResultCache(const std::string& dir, unsigned long long maxBytes);
+
+    // load() finds the results for the given input and returns true, or
+    // returns false if there aren't any (or if needLog is set and they were
+    // stored without a log)
+    bool load(const Trace& trace, Fnv1aHash::Value traceHash, bool needLog, CachedResult& result);
+
+    // store() saves the results for the given input, replacing any that
+    // were already there, then evicts entries to keep within maxBytes.
+    // Failing to write the cache isn't an error; it just won't be a hit.
+    void store(const Trace& trace, Fnv1aHash::Value traceHash, const CachedResult& result);
+
+private:
+    std::filesystem::path entryPath(Fnv1aHash::Value traceHash) const;
+    void evict();
+
+    std::filesystem::path dir;
+    unsigned long long maxBytes;
+};
+
+#endif
@@ -0,0 +1,139 @@
+
+#include "Simulation.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <string>
+
+
+// Creates a two dimensional array with:
+// (1) how long customer is in register
+// (2) how long is the process time for the register
+void makeRegTime(int regTime[][2], const std::vector<int>& regTimes)
+{
+    for (std::size_t i = 0; i < regTimes.size(); i++){
+        regTime[i][0] = 0;
+        regTime[i][1] = regTimes[i];
+    }
+}
+
+// Determines whether a register has to be visited every tick even when
+// nobody is waiting for it: either it's serving a customer, or it has a
+// process time of 0, in which case it exits a customer every tick
+bool regActive(int regTime[][2], int i)
+{
+    return regTime[i][0] > 0 || regTime[i][1] == 0;
+}
+
+// Creates the set of registers that regActive() holds for
+DynamicBitset makeActiveRegs(int regTime[][2], int numOfRegs)
+{
+    DynamicBitset activeRegs(numOfRegs);
+    for (int i = 0; i < numOfRegs; i++){
+        activeRegs.assign(i, regActive(regTime, i));
+    }
+    return activeRegs;
+}
+
+// Counts the registers that still have a customer in them
+int countLeftInReg(int regTime[][2], int numOfRegs)
+{
+    int leftInReg = 0;
+    for (int i = 0; i < numOfRegs; i++){
+        if (regTime[i][0] > 0){
+            leftInReg++;
+        }
+    }
+    return leftInReg;
+}
+
+// Determines whether a simulation is certain to break its limits.  Lost
+// customers can only go up.  The average wait can't end up any lower than
+// if every customer who hasn't been lost so far went on to exit their line
+// without waiting.
+bool limitsBroken(const SimLimits& limits, const SimStats& stats)
+{
+    if (stats.totalLost > limits.maxLost)
+        return true;
+
+    long long mostExits = limits.totalCustomers - stats.totalLost;
+    return mostExits > 0 && stats.totalWait > limits.maxAvgWait * mostExits;
+}
+
+// Splits the registers into ranges for numWorkers workers, each a whole
+// number of bitset words so that no two workers ever write the same word
+std::vector<RegWorker> makeRegWorkers(int numOfRegs, int numWorkers)
+{
+    unsigned int words = (numOfRegs + DynamicBitset::WordBits - 1) / DynamicBitset::WordBits;
+    unsigned int wordsPerWorker = (words + numWorkers - 1) / numWorkers;
+    std::vector<RegWorker> workers(numWorkers);
+    for (int w = 0; w < numWorkers; w++){
+        workers[w].firstWord = std::min(words, w * wordsPerWorker);
+        workers[w].lastWord = std::min(words, (w + 1) * wordsPerWorker);
+    }
+    return workers;
+}
+
+// Prints the events the workers recorded from timer up to until: tick by
+// tick, and within a tick in worker (and so register) order.  They're
+// recorded in the timeline (if any) here too, since the workers can't
+// share it.  The log is flushed once, after all of them.
+void printRegEvents(std::vector<RegWorker>& workers, int timer, int until, std::ostream& log, Timeline* timeline)
+{
+    std::vector<std::size_t> next(workers.size(), 0);
+    for (; timer < until; timer += 5){
+        for (std::size_t w = 0; w < workers.size(); w++){
+            std::vector<RegEvent>& events = workers[w].events;
+            for (; next[w] < events.size() && events[next[w]].timer == timer; next[w]++){
+                const RegEvent& event = events[next[w]];
+                if (event.lineLength < 0){
+                    log << timer << " exited register " << event.reg+1 << '\n';
+                    if (timeline != nullptr)
+                        timeline->regExited(event.reg, timer);
+                }
+                else{
+                    log << timer << " exited line " << event.reg+1 << " length " << event.lineLength;
+                    log << " wait time " << event.wait << '\n';
+                    log << timer << " entered register " << event.reg+1 << '\n';
+                    if (timeline != nullptr){
+                        timeline->regEntered(event.reg, timer);
+                        timeline->lineChanged(event.reg, timer, event.lineLength);
+                    }
+                }
+            }
+        }
+    }
+    log.flush();
+}
+
+// Prints the STATS section of the output
+void printStats(const SimStats& stats, std::ostream& out)
+{
+    out << std::endl << "STATS" << std::endl;
+    out << "Entered Line    : " << stats.totalEntered << std::endl;
+    out << "Exited Line     : " << stats.exitedLine << std::endl;
+    out << "Exited Register : " << stats.exitedReg << std::endl;
+    out << "Avg Wait Time   : " << std::setprecision(2)<<std::fixed
+        << stats.totalWait/(float)stats.exitedLine << std::endl;
+    out << "Left In Line    : " << stats.leftInLine << std::endl;
+    out << "Left In Register: " << stats.leftInReg << std::endl;
+    out << "Lost            : " << stats.totalLost << std::endl;
+}
+
+// Prints the MEMORY section of the output, which is only there when memory
+// accounting is compiled in: for each line the most customers that were
+// in it at once and what it allocated, then what all lines allocated
+void printMemory(const SimStats& stats, std::ostream& out)
+{
+    out << std::endl << "MEMORY" << std::endl;
+    for (std::size_t i = 0; i < stats.lineMemory.size(); i++){
+        const MemoryStats& memory = stats.lineMemory[i];
+        std::string label = stats.lineMemory.size() == 1 ? "Line" : "Line " + std::to_string(i + 1);
+        label.resize(std::max<std::size_t>(label.size(), 16), ' ');
+        out << label << ": peak " << memory.peakValues << " customers, " << memory.liveNodes << " nodes, "
+            << memory.liveBytes << " bytes, peak " << memory.peakBytes << " bytes, "
+            << memory.allocations << " allocations" << std::endl;
+    }
+    const MemoryStats& total = stats.totalMemory;
+    out << "All Lines       : " << total.liveNodes << " nodes, " << total.liveBytes << " bytes, peak "
+        << total.peakBytes << " bytes, " << total.allocations << " allocations" << std::endl;
+}
@@ -0,0 +1,538 @@
+// Simulation.hpp
+
+#ifndef SIMULATION_HPP
+#define SIMULATION_HPP
+
+#include <ostream>
+#include <vector>
+#include "DynamicBitset.hpp"
+#include "MemoryAccount.hpp"
+#include "MinMaxTree.hpp"
+#include "WorkerPool.hpp"
+#include "Timeline.hpp"
+#include "Trace.hpp"
+
+
+// What happened over the course of a simulation
+struct SimStats
+{
+    int totalLost = 0;
+    int totalEntered = 0;
+    int totalWait = 0;
+    int exitedLine = 0;
+    int exitedReg = 0;
+    int leftInLine = 0;
+    int leftInReg = 0;
+
+    // Only filled in when memory accounting is compiled in (see
+    // MemoryAccount.hpp): what each line allocated over the simulation,
+    // and what all of them together had allocated by its end
+    std::vector<MemoryStats> lineMemory;
+    MemoryStats totalMemory;
+};
+
+// Limits on the outcome of a simulation.  A simulation that's given limits
+// stops as soon as it's certain to break one of them, rather than running
+// to the end.  totalCustomers is how many customers arrive over the whole
+// simulation, which bounds how many can still exit their lines.
+struct SimLimits
+{
+    int maxLost;
+    double maxAvgWait;
+    long long totalCustomers;
+};
+
+// An event that a register produces during a tick of parallelMultiLine().
+// Workers record these rather than printing them, so that they can be
+// printed afterward in the same order that multiLine() prints them.
+struct RegEvent
+{
+    int timer;
+    int reg;
+    int lineLength;     // -1 if a customer exited the register
+    int wait;
+};
+
+// A worker of parallelMultiLine(), which is responsible for the registers
+// in the bitset words from firstWord up to (but not including) lastWord,
+// and what happened at them while it last ran
+struct RegWorker
+{
+    unsigned int firstWord;
+    unsigned int lastWord;
+    std::vector<RegEvent> events;
+    int totalWait = 0;
+    int exitedLine = 0;
+    int exitedReg = 0;
+};
+
+
+template <typename Line>
+bool simulate(const SimConfig& config, int regTime[][2], ArrivalSource& arrivals, std::ostream& log,
+              SimStats& stats, int numThreads, const SimLimits* limits, Timeline* timeline);
+template <typename Line>
+bool singleLine(const SimConfig& config, int regTime[][2], ArrivalSource& arrivals, std::ostream& log,
+                SimStats& stats, const SimLimits* limits, Timeline* timeline);
+template <typename Line>
+bool multiLine(const SimConfig& config, int regTime[][2], ArrivalSource& arrivals, std::ostream& log,
+               SimStats& stats, const SimLimits* limits, Timeline* timeline);
+template <typename Line>
+bool parallelMultiLine(const SimConfig& config, int regTime[][2], ArrivalSource& arrivals, std::ostream& log,
+                       SimStats& stats, int numThreads, const SimLimits* limits, Timeline* timeline);
+template <typename Line>
+void advanceRegs(std::vector<Line>& regs, DynamicBitset& activeRegs, DynamicBitset& waitingLines,
+                 int regTime[][2], RegWorker& worker, int timer, int until);
+template <typename Line>
+void enterReg(std::vector<Line>& regs, int timer, int wait, int regTime[][2], int i, std::ostream& log,
+              Timeline* timeline);
+template <typename Line>
+std::vector<Line> makeLines(int numOfRegs);
+template <typename Line>
+void recordMemory(const Line* lines, std::size_t count, SimStats& stats);
+template <typename Line>
+int insertCust(std::vector<Line>& regs, DynamicBitset& waitingLines, int numOfRegs,int customerCount,
+               int timer, int maxLineLen, std::ostream& log, Timeline* timeline, MinMaxTree& lengths);
+template <typename Line>
+void jockey(std::vector<Line>& regs, MinMaxTree& lengths, DynamicBitset& waitingLines, int margin, int timer,
+            std::ostream& log, Timeline* timeline);
+
+void makeRegTime(int regTime[][2], const std::vector<int>& regTimes);
+bool regActive(int regTime[][2], int i);
+DynamicBitset makeActiveRegs(int regTime[][2], int numOfRegs);
+int countLeftInReg(int regTime[][2], int numOfRegs);
+bool limitsBroken(const SimLimits& limits, const SimStats& stats);
+std::vector<RegWorker> makeRegWorkers(int numOfRegs, int numWorkers);
+void printRegEvents(std::vector<RegWorker>& workers, int timer, int until, std::ostream& log, Timeline* timeline);
+void printStats(const SimStats& stats, std::ostream& out);
+void printMemory(const SimStats& stats, std::ostream& out);
+
+
+
+// Runs the simulation in the configured line form, keeping lines in Lines,
+// and returns true, or returns false if it was stopped early because it
+// was certain to break the given limits (if any).  Lines only ever interact
+// in multi-line mode when customers arrive (unless they jockey), so there
+// numThreads > 1 splits the registers between that many threads.  What
+// happens is recorded in the timeline too, if there is one.  The next
+// arrival is only read at the start of a tick, once the last one has been
+// placed and its tick has been run and logged, so that waiting on a live
+// feed (see LiveFeed.hpp) never holds back the log of what's already been
+// simulated.
+template <typename Line>
+bool simulate(const SimConfig& config, int regTime[][2], ArrivalSource& arrivals, std::ostream& log,
+              SimStats& stats, int numThreads, const SimLimits* limits, Timeline* timeline)
+{
+    bool finished = true;
+
+    if(config.lineForm == 'M' && numThreads > 1 && config.jockeyMargin == 0)
+    {
+        finished = parallelMultiLine<Line>(config, regTime, arrivals, log, stats, numThreads, limits, timeline);
+    }
+
+    else if(config.lineForm == 'M')
+    {
+        finished = multiLine<Line>(config, regTime, arrivals, log, stats, limits, timeline);
+    }
+
+    else if(config.lineForm == 'S')
+    {
+        finished = singleLine<Line>(config, regTime, arrivals, log, stats, limits, timeline);
+    }
+
+    stats.leftInReg = countLeftInReg(regTime, config.numOfRegs);
+    if (timeline != nullptr)
+        timeline->finish(config.simLen);
+    return finished;
+}
+
+// Runs the simulation with a single line to the registers
+template <typename Line>
+bool singleLine(const SimConfig& config, int regTime[][2], ArrivalSource& arrivals, std::ostream& log,
+                SimStats& stats, const SimLimits* limits, Timeline* timeline)
+{
+    int simLen = config.simLen;
+    int maxLineLen = config.maxLineLen;
+    Line line;
+    DynamicBitset activeRegs = makeActiveRegs(regTime, config.numOfRegs);
+    bool finished = true;
+    int timer = 0;
+    int customerCount = 0, customerTime = -1;
+    bool pending = false, more = true;
+
+    while (timer < simLen) {
+        if (!pending && more)
+            pending = more = arrivals.next(customerCount, customerTime);
+        if (pending && customerTime == timer) {
+            for (int i = 0; i < customerCount; i++) {
+                if (line.size() < maxLineLen) {
+                    line.enqueue(timer);
+                    log << timer << " entered line length " << line.size() << std::endl;
+                    stats.totalEntered++;
+                    if (timeline != nullptr)
+                        timeline->lineChanged(0, timer, line.size());
+                }
+                else{
+                    log << timer << " lost" << std::endl;
+                    stats.totalLost++;
+                }
+            }
+            pending = false;
+        }
+
+        if (limits != nullptr && limitsBroken(*limits, stats)){
+            finished = false;
+            break;
+        }
+
+        // Only active registers have anything to do, unless there's
+        // someone in line, in which case every idle register takes a
+        // customer (in order) until the line runs out.
+        for (unsigned int w = 0; w < activeRegs.wordCount(); w++){
+            DynamicBitset::Word regBits = activeRegs.word(w);
+            if (line.size() > 0)
+                regBits = activeRegs.fullWord(w);
+
+            while (regBits != 0){
+                int i = w * DynamicBitset::WordBits + DynamicBitset::lowestBit(regBits);
+                regBits &= regBits - 1;
+
+                if (regTime[i][0] == regTime[i][1]){
+                    log << timer << " exited register " << i+1 <<std::endl;
+                    regTime[i][0] = 0;
+                    stats.exitedReg++;
+                    if (timeline != nullptr)
+                        timeline->regExited(i, timer);
+                }
+
+                // tryFront() doubles as the check for an empty line
+                const int* arrived = regTime[i][0] == 0 ? line.tryFront() : nullptr;
+                if (arrived != nullptr){
+                    int wait = timer - *arrived;
+                    stats.totalWait += wait;
+                    log << timer << " exited line length " << line.size()-1;
+                    log << " wait time " << wait << std::endl;
+                    log << timer << " entered register " << i+1 << std::endl;
+                    line.tryDequeue();
+                    regTime[i][0] = 5;
+                    stats.exitedLine++;
+                    if (timeline != nullptr){
+                        timeline->regEntered(i, timer);
+                        timeline->lineChanged(0, timer, line.size());
+                    }
+                }
+                else if (regTime[i][0] > 0){
+                    regTime[i][0] += 5;
+                }
+                activeRegs.assign(i, regActive(regTime, i));
+            }
+        }
+
+        timer += 5;
+    }
+    if (finished)
+        log << simLen << " end" << std::endl;
+    stats.leftInLine = line.size();
+    recordMemory(&line, 1, stats);
+    return finished;
+}
+
+// Runs the simulation with multiple lines, one for each register.  Every
+// line's length is kept in a MinMaxTree as well, so that neither placing a
+// customer nor checking for a jockey after one leaves a line ever has to
+// look at every line.
+template <typename Line>
+bool multiLine(const SimConfig& config, int regTime[][2], ArrivalSource& arrivals, std::ostream& log,
+               SimStats& stats, const SimLimits* limits, Timeline* timeline)
+{
+    int simLen = config.simLen;
+    int numOfRegs = config.numOfRegs;
+    std::vector<Line> regs = makeLines<Line>(numOfRegs);
+    DynamicBitset activeRegs = makeActiveRegs(regTime, numOfRegs);
+    DynamicBitset waitingLines(numOfRegs);
+    MinMaxTree lengths(numOfRegs);
+    bool finished = true;
+    int timer = 0;
+    int customerCount = 0, customerTime = -1;
+    bool pending = false, more = true;
+
+    while (timer < simLen){
+        if (!pending && more)
+            pending = more = arrivals.next(customerCount, customerTime);
+        if (pending && customerTime == timer){
+            int lostInLine = insertCust(regs, waitingLines, numOfRegs, customerCount, timer,
+                                        config.maxLineLen, log, timeline, lengths);
+            stats.totalLost += lostInLine;
+            stats.totalEntered += customerCount - lostInLine;
+            pending = false;
+        }
+
+        if (limits != nullptr && limitsBroken(*limits, stats)){
+            finished = false;
+            break;
+        }
+
+        // A register with nobody in it and nobody in its line has
+        // nothing to do this tick, so only visit the rest.
+        for (unsigned int w = 0; w < activeRegs.wordCount(); w++){
+            DynamicBitset::Word regBits = activeRegs.word(w) | waitingLines.word(w);
+
+            while (regBits != 0){
+                int i = w * DynamicBitset::WordBits + DynamicBitset::lowestBit(regBits);
+                regBits &= regBits - 1;
+
+                if (regTime[i][0] == regTime[i][1]){
+                    log << timer << " exited register " << i+1 <<std::endl;
+                    regTime[i][0] = 0;
+                    stats.exitedReg++;
+                    if (timeline != nullptr)
+                        timeline->regExited(i, timer);
+                }
+
+                const int* arrived = regTime[i][0] == 0 ? regs[i].tryFront() : nullptr;
+                if (arrived != nullptr){
+                    int wait = timer - *arrived;
+                    stats.totalWait += wait;
+                    enterReg(regs, timer, wait, regTime, i, log, timeline);
+                    stats.exitedLine++;
+                    if (regs[i].size() == 0)
+                        waitingLines.reset(i);
+                    lengths.set(i, regs[i].size());
+                    if (config.jockeyMargin > 0)
+                        jockey(regs, lengths, waitingLines, config.jockeyMargin, timer, log, timeline);
+                }
+                else if (regTime[i][0] > 0){
+                    regTime[i][0] += 5;
+                }
+                activeRegs.assign(i, regActive(regTime, i));
+            }
+        }
+        timer += 5;
+    }
+
+    if (finished)
+        log << simLen << " end" << std::endl;
+
+    for (int i = 0; i < numOfRegs; i++){
+        stats.leftInLine += regs[i].size();
+    }
+    recordMemory(regs.data(), regs.size(), stats);
+    return finished;
+}
+
+// Runs the same simulation as multiLine(), but with the registers (and
+// their lines) split between numThreads threads.  Between two arrivals
+// every thread advances its own registers on its own, recording what
+// happens; at each arrival the threads stop, their events are printed tick
+// by tick in register order, the lengths of the lines they took customers
+// from are updated in the MinMaxTree of line lengths (which only this
+// thread ever touches), and the new customers are placed in lines.
+template <typename Line>
+bool parallelMultiLine(const SimConfig& config, int regTime[][2], ArrivalSource& arrivals, std::ostream& log,
+                       SimStats& stats, int numThreads, const SimLimits* limits, Timeline* timeline)
+{
+    int simLen = config.simLen;
+    int numOfRegs = config.numOfRegs;
+    std::vector<Line> regs = makeLines<Line>(numOfRegs);
+    DynamicBitset activeRegs = makeActiveRegs(regTime, numOfRegs);
+    DynamicBitset waitingLines(numOfRegs);
+    MinMaxTree lengths(numOfRegs);
+    WorkerPool pool(numThreads);
+    std::vector<RegWorker> workers = makeRegWorkers(numOfRegs, pool.size());
+    bool finished = true;
+    int timer = 0;
+    int customerCount = 0, customerTime = -1;
+    bool pending = false, more = true;
+
+    while (timer < simLen){
+        if (!pending && more)
+            pending = more = arrivals.next(customerCount, customerTime);
+        if (pending && customerTime == timer){
+            int lostInLine = insertCust(regs, waitingLines, numOfRegs, customerCount, timer,
+                                        config.maxLineLen, log, timeline, lengths);
+            stats.totalLost += lostInLine;
+            stats.totalEntered += customerCount - lostInLine;
+            pending = false;
+        }
+
+        if (limits != nullptr && limitsBroken(*limits, stats)){
+            finished = false;
+            break;
+        }
+
+        // Run up to the next arrival, or just through this tick if it hasn't
+        // been read yet.  An arrival that isn't on a later tick will never
+        // be reached.
+        int until = simLen;
+        if (!pending && more)
+            until = timer + 5;
+        else if (pending && customerTime > timer && customerTime < simLen && customerTime % 5 == 0)
+            until = customerTime;
+
+        pool.run([&](unsigned int w){
+            advanceRegs(regs, activeRegs, waitingLines, regTime, workers[w], timer, until);
+        });
+        printRegEvents(workers, timer, until, log, timeline);
+        for (RegWorker& worker : workers){
+            stats.totalWait += worker.totalWait;
+            stats.exitedLine += worker.exitedLine;
+            stats.exitedReg += worker.exitedReg;
+            for (const RegEvent& event : worker.events){
+                if (event.lineLength >= 0)
+                    lengths.set(event.reg, event.lineLength);
+            }
+        }
+        timer = until;
+    }
+
+    if (finished)
+        log << simLen << " end" << std::endl;
+
+    for (int i = 0; i < numOfRegs; i++){
+        stats.leftInLine += regs[i].size();
+    }
+    recordMemory(regs.data(), regs.size(), stats);
+    return finished;
+}
+
+// Advances a worker's registers through the ticks from timer up to (but
+// not including) until, as multiLine() would, recording their events
+template <typename Line>
+void advanceRegs(std::vector<Line>& regs, DynamicBitset& activeRegs, DynamicBitset& waitingLines,
+                 int regTime[][2], RegWorker& worker, int timer, int until)
+{
+    worker.events.clear();
+    worker.totalWait = 0;
+    worker.exitedLine = 0;
+    worker.exitedReg = 0;
+
+    for (; timer < until; timer += 5){
+        for (unsigned int w = worker.firstWord; w < worker.lastWord; w++){
+            DynamicBitset::Word regBits = activeRegs.word(w) | waitingLines.word(w);
+
+            while (regBits != 0){
+                int i = w * DynamicBitset::WordBits + DynamicBitset::lowestBit(regBits);
+                regBits &= regBits - 1;
+
+                if (regTime[i][0] == regTime[i][1]){
+                    worker.events.push_back(RegEvent{timer, i, -1, 0});
+                    regTime[i][0] = 0;
+                    worker.exitedReg++;
+                }
+
+                const int* arrived = regTime[i][0] == 0 ? regs[i].tryFront() : nullptr;
+                if (arrived != nullptr){
+                    int wait = timer - *arrived;
+                    worker.events.push_back(RegEvent{timer, i, int(regs[i].size()) - 1, wait});
+                    worker.totalWait += wait;
+                    regs[i].tryDequeue();
+                    regTime[i][0] = 5;
+                    worker.exitedLine++;
+                    if (regs[i].size() == 0)
+                        waitingLines.reset(i);
+                }
+                else if (regTime[i][0] > 0){
+                    regTime[i][0] += 5;
+                }
+                activeRegs.assign(i, regActive(regTime, i));
+            }
+        }
+    }
+}
+
+// Moves a customer, who waited in line for wait seconds, from the (non-empty)
+// line and into the register
+template <typename Line>
+void enterReg(std::vector<Line>& regs, int timer, int wait, int regTime[][2], int i, std::ostream& log,
+              Timeline* timeline)
+{
+    log << timer << " exited line " << i+1 << " length " << regs[i].size()-1;
+    log << " wait time " << wait << std::endl;
+    log << timer << " entered register " << i+1 << std::endl;
+    regs[i].tryDequeue();
+    regTime[i][0] = 5;
+    if (timeline != nullptr){
+        timeline->regEntered(i, timer);
+        timeline->lineChanged(i, timer, regs[i].size());
+    }
+}
+
+// creates a vector that holds all the queues, representing lines
+template <typename Line>
+std::vector<Line> makeLines(int numOfRegs)
+{
+    std::vector<Line> regs;
+    for (int i = 0; i < numOfRegs; i++){
+        regs.push_back(Line());
+    }
+    return regs;
+}
+
+// Records what the given lines allocated, if memory accounting is
+// compiled in
+template <typename Line>
+void recordMemory(const Line* lines, std::size_t count, SimStats& stats)
+{
+    if (!MemoryAccount::Enabled)
+        return;
+    for (std::size_t i = 0; i < count; i++){
+        stats.lineMemory.push_back(lines[i].memory());
+    }
+    stats.totalMemory = MemoryAccount::totalMemory();
+}
+
+// Insert each of the new customers into the shortest line
+// If all lines are full then inform about a lost customer
+// The shortest line is looked up in lengths, which holds every line's
+// length, rather than searched for
+template <typename Line>
+int insertCust(std::vector<Line>& regs, DynamicBitset& waitingLines, int numOfRegs,int customerCount,
+               int timer, int maxLineLen, std::ostream& log, Timeline* timeline, MinMaxTree& lengths){
+    int lost = 0;
+    for (int i = 0; i < customerCount; i++){
+        int line = numOfRegs;
+        if (numOfRegs > 0 && lengths.get(lengths.minIndex()) < maxLineLen)
+            line = lengths.minIndex();
+        if (line == numOfRegs){
+            log << timer << " lost" << std::endl;
+            lost++;
+        }
+        else{
+            regs[line].enqueue(timer);
+            waitingLines.set(line);
+            lengths.set(line, regs[line].size());
+            log << timer << " entered line " << line+1 << " length " << regs[line].size() << std::endl;
+            if (timeline != nullptr)
+                timeline->lineChanged(line, timer, regs[line].size());
+        }
+    }
+    return lost;
+}
+
+// Moves the customer at the end of the longest line to the end of the
+// shortest one (keeping the time they arrived) for as long as the longest
+// line is at least margin customers longer.  Each move is O(log lines).
+template <typename Line>
+void jockey(std::vector<Line>& regs, MinMaxTree& lengths, DynamicBitset& waitingLines, int margin, int timer,
+            std::ostream& log, Timeline* timeline)
+{
+    for (;;){
+        int from = lengths.maxIndex(), to = lengths.minIndex();
+        if (lengths.get(from) - lengths.get(to) < margin)
+            break;
+
+        int arrived = *regs[from].tryBack();
+        regs[from].tryDequeueBack();
+        regs[to].enqueue(arrived);
+        lengths.set(from, regs[from].size());
+        lengths.set(to, regs[to].size());
+        waitingLines.set(to);
+        log << timer << " jockeyed from line " << from+1 << " length " << regs[from].size();
+        log << " to line " << to+1 << " length " << regs[to].size() << std::endl;
+        if (timeline != nullptr){
+            timeline->lineChanged(from, timer, regs[from].size());
+            timeline->lineChanged(to, timer, regs[to].size());
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,76 @@
+
+#include "Timeline.hpp"
+
+
+namespace
+{
+    const long long MicrosPerSecond = 1000000;
+
+    const int RegistersPid = 1;
+    const int LinesPid = 2;
+}
+
+
+Timeline::Timeline(int numOfRegs, int numOfLines, std::size_t capacity)
+    : events{capacity}, busySince(numOfRegs > 0 ? numOfRegs : 0, -1), numOfLines{numOfLines}
+{
+}
+
+void Timeline::lineChanged(int line, int timer, int length)
+{
+    events.push(Event{timer, line, length, Kind::LineLength});
+}
+
+void Timeline::regEntered(int reg, int timer)
+{
+    busySince[reg] = timer;
+}
+
+// A register with a process time of 0 "exits" a customer every tick
+// while it's idle, which doesn't end any span
+void Timeline::regExited(int reg, int timer)
+{
+    if (busySince[reg] < 0)
+        return;
+    events.push(Event{timer, reg, busySince[reg], Kind::Busy});
+    busySince[reg] = -1;
+}
+
+void Timeline::finish(int timer)
+{
+    for (std::size_t reg = 0; reg < busySince.size(); reg++){
+        regExited(reg, timer);
+    }
+}
+
+// Registers are the threads of one process, so that each one gets a track
+// of its own, and lines are counters of another
+void Timeline::exportTrace(std::ostream& out) const
+{
+    out << "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"droppedEvents\":" << events.dropped() << "},\n";
+    out << "\"traceEvents\":[\n";
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << RegistersPid
+        << ",\"args\":{\"name\":\"Registers\"}},\n";
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << LinesPid << ",\"args\":{\"name\":\"Lines\"}}";
+    for (std::size_t reg = 0; reg < busySince.size(); reg++){
+        out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << RegistersPid << ",\"tid\":" << reg + 1
+            << ",\"args\":{\"name\":\"register " << reg + 1 << "\"}}";
+    }
+
+    for (std::size_t i = 0; i < events.size(); i++){
+        const Event& event = events[i];
+        if (event.kind == Kind::Busy){
+            out << ",\n{\"name\":\"busy\",\"cat\":\"register\",\"ph\":\"X\",\"pid\":" << RegistersPid
+                << ",\"tid\":" << event.track + 1 << ",\"ts\":" << event.value * MicrosPerSecond
+                << ",\"dur\":" << (event.timer - event.value) * MicrosPerSecond << "}";
+        }
+        else{
+            out << ",\n{\"name\":\"line";
+            if (numOfLines > 1)
+                out << ' ' << event.track + 1;
+            out << "\",\"cat\":\"line\",\"ph\":\"C\",\"pid\":" << LinesPid << ",\"ts\":"
+                << event.timer * MicrosPerSecond << ",\"args\":{\"length\":" << event.value << "}}";
+        }
+    }
+    out << "\n]}\n";
+}
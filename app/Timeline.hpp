@@ -0,0 +1,57 @@
+// Timeline.hpp
+
+#ifndef TIMELINE_HPP
+#define TIMELINE_HPP
+
+#include <cstddef>
+#include <ostream>
+#include <vector>
+#include "RingBuffer.hpp"
+
+
+// Records when each register is busy and how long each line is over the
+// course of a simulation, for viewing in a trace viewer.  Recording only
+// writes into a ring buffer that's allocated up front, so a long
+// simulation keeps its most recent events rather than running out of
+// memory.  Busy spans are recorded whole when the customer exits the
+// register, so the buffer never holds half of one.
+class Timeline
+{
+public:
+    Timeline(int numOfRegs, int numOfLines, std::size_t capacity);
+
+    // The simulation calls these as things happen: a line's length
+    // changed, a customer entered a register, or one exited a register
+    void lineChanged(int line, int timer, int length);
+    void regEntered(int reg, int timer);
+    void regExited(int reg, int timer);
+
+    // Ends the spans of the customers who are still in a register when
+    // the simulation ends at the given time
+    void finish(int timer);
+
+    // Writes everything that was recorded in the Chrome trace event format
+    // (which Perfetto reads too), with a track per register showing its
+    // busy spans and a counter per line showing its length.  One second of
+    // simulation shows as one second.
+    void exportTrace(std::ostream& out) const;
+
+private:
+    enum class Kind : unsigned char { Busy, LineLength };
+
+    // For Busy, track is the register and the span is [start, timer); for
+    // LineLength, track is the line and value is its length
+    struct Event
+    {
+        int timer;
+        int track;
+        int value;
+        Kind kind;
+    };
+
+    RingBuffer<Event> events;
+    std::vector<int> busySince;     // -1 while a register is idle
+    int numOfLines;
+};
+
+#endif
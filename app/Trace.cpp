@@ -0,0 +1,101 @@
+
+#include "Trace.hpp"
+#include "BinaryTrace.hpp"
+
+
+StreamArrivals::StreamArrivals(std::istream& in)
+    : in{in}
+{
+}
+
+bool StreamArrivals::next(int& customerCount, int& customerTime)
+{
+    return bool(in >> customerCount >> customerTime);
+}
+
+
+TraceArrivals::TraceArrivals(const Trace& trace)
+    : arrivals{trace.arrivals}
+{
+}
+
+bool TraceArrivals::next(int& customerCount, int& customerTime)
+{
+    if (nextArrival == arrivals.size())
+        return false;
+    customerCount = arrivals[nextArrival].customerCount;
+    customerTime = arrivals[nextArrival].customerTime;
+    nextArrival++;
+    return true;
+}
+
+
+// Reads the first line of the input and the registers' process times,
+// hashing every value as it's read if given a hash
+bool readSetup(std::istream& in, SimConfig& config, std::vector<int>& regTimes, Fnv1aHash* hash)
+{
+    if (!(in >> config.simLen >> config.numOfRegs >> config.maxLineLen >> config.lineForm))
+        return false;
+    config.simLen *= 60;
+
+    regTimes.assign(config.numOfRegs > 0 ? config.numOfRegs : 0, 0);
+    for (int& regTime : regTimes){
+        in >> regTime;
+    }
+    if (hash != nullptr){
+        hash->addInt(config.simLen);
+        hash->addInt(config.numOfRegs);
+        hash->addInt(config.maxLineLen);
+        hash->addInt(config.lineForm);
+        for (int regTime : regTimes)
+            hash->addInt(regTime);
+    }
+    return bool(in);
+}
+
+// Reads a whole input in either format, hashing every value as it's read
+// if given a hash
+bool readTrace(std::istream& in, Trace& trace, Fnv1aHash* hash)
+{
+    if (isBinaryTrace(in))
+        return readBinaryTrace(in, trace, hash);
+
+    if (!readSetup(in, trace.config, trace.regTimes, hash))
+        return false;
+
+    Arrival arrival;
+    trace.arrivals.clear();
+    while (in >> arrival.customerCount >> arrival.customerTime){
+        trace.arrivals.push_back(arrival);
+        if (hash != nullptr){
+            hash->addInt(arrival.customerCount);
+            hash->addInt(arrival.customerTime);
+        }
+    }
+    return true;
+}
+
+// Reads the setup of an input in either format, and returns where to read
+// the rest of its arrivals from
+std::unique_ptr<ArrivalSource> readInput(std::istream& in, SimConfig& config, std::vector<int>& regTimes)
+{
+    if (isBinaryTrace(in)){
+        if (!readBinarySetup(in, config, regTimes))
+            return nullptr;
+        return std::unique_ptr<ArrivalSource>{new BinaryArrivals(in)};
+    }
+
+    if (!readSetup(in, config, regTimes))
+        return nullptr;
+    return std::unique_ptr<ArrivalSource>{new StreamArrivals(in)};
+}
+
+// Adds up the customers that arrive over the course of a trace
+long long traceCustomers(const Trace& trace)
+{
+    long long customers = 0;
+    for (const Arrival& arrival : trace.arrivals){
+        customers += arrival.customerCount;
+    }
+    return customers;
+}
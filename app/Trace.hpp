@@ -0,0 +1,96 @@
+// Trace.hpp
+
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <cstddef>
+#include <istream>
+#include <memory>
+#include <vector>
+#include "Fnv1aHash.hpp"
+
+
+// The first line of the input: how long the simulation runs (in seconds;
+// the input gives it in minutes), how many registers there are, how long
+// a line can get, and whether there's a single line ('S') or one line per
+// register ('M').  jockeyMargin isn't part of the input: when it's set
+// (to 2 or more) in multi-line mode, the customer at the end of the
+// longest line moves to the end of the shortest one whenever the longest
+// is at least that many customers longer.
+struct SimConfig
+{
+    int simLen;
+    int numOfRegs;
+    int maxLineLen;
+    char lineForm;
+    int jockeyMargin = 0;
+};
+
+// customerCount customers arriving at customerTime
+struct Arrival
+{
+    int customerCount;
+    int customerTime;
+};
+
+// A whole input, read into memory so that it can be simulated more than once
+struct Trace
+{
+    SimConfig config;
+    std::vector<int> regTimes;
+    std::vector<Arrival> arrivals;
+};
+
+
+// Where a simulation gets its arrivals from, one at a time and in order
+class ArrivalSource
+{
+public:
+    virtual ~ArrivalSource() = default;
+
+    // next() reads the next arrival and returns true, or returns false if
+    // there isn't one
+    virtual bool next(int& customerCount, int& customerTime) = 0;
+};
+
+// Reads arrivals as "customerCount customerTime" pairs of text
+class StreamArrivals : public ArrivalSource
+{
+public:
+    explicit StreamArrivals(std::istream& in);
+    bool next(int& customerCount, int& customerTime) override;
+
+private:
+    std::istream& in;
+};
+
+// Reads the arrivals of a Trace that's already in memory
+class TraceArrivals : public ArrivalSource
+{
+public:
+    explicit TraceArrivals(const Trace& trace);
+    bool next(int& customerCount, int& customerTime) override;
+
+private:
+    const std::vector<Arrival>& arrivals;
+    std::size_t nextArrival = 0;
+};
+
+
+// Reads the first line of the input and the registers' process times,
+// hashing every value as it's read if given a hash
+bool readSetup(std::istream& in, SimConfig& config, std::vector<int>& regTimes, Fnv1aHash* hash = nullptr);
+
+// Reads a whole input in either format, hashing every value as it's read
+// if given a hash
+bool readTrace(std::istream& in, Trace& trace, Fnv1aHash* hash = nullptr);
+
+// Reads the setup of an input in either the text or the binary format (see
+// BinaryTrace.hpp), and returns where to read the rest of its arrivals
+// from, or nullptr if the setup couldn't be read
+std::unique_ptr<ArrivalSource> readInput(std::istream& in, SimConfig& config, std::vector<int>& regTimes);
+
+// Adds up the customers that arrive over the course of a trace
+long long traceCustomers(const Trace& trace);
+
+#endif
@@ -1,230 +1,446 @@
 
 #include <iostream>
 #include "Queue.hpp"
+#include "CompactQueue.hpp"
+#include "UnrolledLinkedList.hpp"
+#include "Trace.hpp"
+#include "Simulation.hpp"
+#include "Optimizer.hpp"
+#include "ResultCache.hpp"
+#include "BinaryTrace.hpp"
+#include "Timeline.hpp"
+#include "Replicas.hpp"
+#include "LiveFeed.hpp"
 #include <vector>
-#include <iomanip>
-
-std::vector<Queue<int>> makeLines(int numOfRegs);
-int shortLine(const std::vector<Queue<int>>& regs, int maxLineLen);
-int insertCust(std::vector<Queue<int>>& regs, int numOfRegs,int customerCount, int timer, int maxLineLen);
-void makeRegTime(int regTime[][2], int numOfRegs);
-void enterReg(std::vector<Queue<int>>& regs, int timer, int regTime[][2], int i);
-void multiLine(int& totalLost, int& totalEntered, int& totalWait, int& exitedLine,
-               int& exitedReg, int regTime[][2], int& LefInLine,int simLen, int numOfRegs, int maxLineLen);
-void singleLine(int& totalLost, int& totalEntered, int& totalWait, int& exitedLine,
-               int& exitedReg, int regTimeArr[][2], int& LefInLine,int simLen, int numOfRegs, int maxLineLen);
-
-int main()
+#include <fstream>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <limits>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <cctype>
+
+// Lines can either be kept in a Queue, one node per customer, in a Queue
+// built on an UnrolledLinkedList, which keeps several customers per cache
+// line, or in a CompactQueue, which packs the (non-decreasing, 5 second
+// apart) arrival times into a byte or so per customer for very long lines.
+using UnrolledLine = Queue<int, UnrolledLinkedList<int>>;
+using CompactLine = CompactQueue<int, 5>;
+
+// How lines are kept, as chosen on the command line
+struct LineStorage
 {
-    int simLen, numOfRegs, maxLineLen;
-    char lineForm;
-    int totalLost = 0;
-    int totalEntered = 0;
-    int totalWait = 0;
-    int exitedLine = 0;
-    int exitedReg = 0;
-    int leftInLine = 0;
-    std::cin >> simLen >> numOfRegs >> maxLineLen >> lineForm;
-    simLen *= 60;
-    int regTime[numOfRegs][2];
-    makeRegTime(regTime, numOfRegs);
+    bool compactLines;
+    bool unrolledLines;
+};
 
-    std::cout << "LOG" << std::endl;
-    std::cout << "0 start" << std::endl;
+void simulateLines(const LineStorage& storage, const SimConfig& config, int regTime[][2], ArrivalSource& arrivals,
+                   std::ostream& log, SimStats& stats, int numThreads, Timeline* timeline);
+bool exportTimeline(const Timeline& timeline, const std::string& path);
+int optimize(const StaffingTarget& target, int jockeyMargin, int numThreads);
+int runReplicas(int numOfReplicas, unsigned long long seed);
+int feed(const std::string& feedPath, double feedRate);
+int simulateCached(const std::string& cacheDir, unsigned long long cacheBytes, bool cacheLog,
+                   const LineStorage& storage, int jockeyMargin, int numThreads);
+bool checkOptions(const std::set<std::string>& given);
+bool checkLineForm(const SimConfig& config, int numThreads, int jockeyMargin);
+bool parseMegabytes(const char* text, unsigned long long& bytes);
 
-    if(lineForm == 'M')
-    {
-        multiLine(totalLost, totalEntered, totalWait, exitedLine, exitedReg,regTime,
-                  leftInLine, simLen, numOfRegs, maxLineLen);
+int main(int argc, char* argv[])
+{
+    LineStorage storage{false, false};
+    bool optimizing = false;
+    std::string cacheDir;
+    unsigned long long cacheBytes = 64ull << 20;
+    bool cacheLog = false;
+    bool converting = false;
+    bool toBinary = false;
+    std::string timelinePath;
+    std::size_t timelineEvents = 1 << 20;
+    int numOfReplicas = 0;
+    unsigned long long seed = 1;
+    int jockeyMargin = 0;
+    std::string listenPath;
+    int statsEvery = 0;
+    std::string feedPath;
+    double feedRate = 0;
+    int numThreads = 1;
+    StaffingTarget target{0, std::numeric_limits<double>::infinity()};
+    std::set<std::string> given;
+    for (int i = 1; i < argc; i++){
+        given.insert(argv[i]);
+        if (std::strcmp(argv[i], "--compact-lines") == 0){
+            storage.compactLines = true;
+        }
+        else if (std::strcmp(argv[i], "--unrolled-lines") == 0){
+            storage.unrolledLines = true;
+        }
+        else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc && std::atoi(argv[i + 1]) > 0){
+            numThreads = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--jockey") == 0 && i + 1 < argc && std::atoi(argv[i + 1]) >= 2){
+            jockeyMargin = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--convert") == 0 && i + 1 < argc
+                 && (std::strcmp(argv[i + 1], "binary") == 0 || std::strcmp(argv[i + 1], "text") == 0)){
+            converting = true;
+            toBinary = std::strcmp(argv[++i], "binary") == 0;
+        }
+        else if (std::strcmp(argv[i], "--timeline") == 0 && i + 1 < argc){
+            timelinePath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--timeline-events") == 0 && i + 1 < argc && std::atoll(argv[i + 1]) > 0){
+            timelineEvents = std::atoll(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--listen") == 0 && i + 1 < argc){
+            listenPath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--stats-every") == 0 && i + 1 < argc && std::atoi(argv[i + 1]) > 0){
+            statsEvery = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--feed") == 0 && i + 1 < argc){
+            feedPath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--feed-rate") == 0 && i + 1 < argc){
+            feedRate = std::atof(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--replicas") == 0 && i + 1 < argc && std::atoi(argv[i + 1]) > 0){
+            numOfReplicas = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc){
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (std::strcmp(argv[i], "--optimize") == 0){
+            optimizing = true;
+        }
+        else if (std::strcmp(argv[i], "--max-lost") == 0 && i + 1 < argc){
+            target.maxLost = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--max-wait") == 0 && i + 1 < argc){
+            target.maxAvgWait = std::atof(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--cache") == 0 && i + 1 < argc){
+            cacheDir = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--cache-size") == 0 && i + 1 < argc && parseMegabytes(argv[i + 1], cacheBytes)){
+            i++;
+        }
+        else if (std::strcmp(argv[i], "--cache-log") == 0){
+            cacheLog = true;
+        }
+        else{
+            std::cerr << "usage: " << argv[0] << " [--compact-lines | --unrolled-lines] [--threads N | --jockey MARGIN]"
+                      << " [--timeline FILE [--timeline-events N]] < input" << std::endl;
+            std::cerr << "       " << argv[0] << " --listen FIFO|SOCKET [--stats-every SECONDS]"
+                      << " [--compact-lines | --unrolled-lines] [--threads N | --jockey MARGIN]"
+                      << " [--timeline FILE [--timeline-events N]]" << std::endl;
+            std::cerr << "         (its FEED latencies run from an arrival being parsed to its being simulated)"
+                      << std::endl;
+            std::cerr << "       " << argv[0] << " --feed FIFO|SOCKET [--feed-rate ARRIVALS_PER_SECOND] < input"
+                      << std::endl;
+            std::cerr << "       " << argv[0] << " --cache DIR [--cache-size MB] [--cache-log]"
+                      << " [--compact-lines | --unrolled-lines] [--threads N | --jockey MARGIN] < input" << std::endl;
+            std::cerr << "       " << argv[0] << " --convert binary|text < input > output" << std::endl;
+            std::cerr << "       " << argv[0] << " --optimize [--max-lost N] [--max-wait SECONDS] [--threads N]"
+                      << " [--jockey MARGIN] < input" << std::endl;
+            std::cerr << "       " << argv[0] << " --replicas K [--seed S] < input" << std::endl;
+            std::cerr << "         (--threads, except with --optimize, and --jockey need an input with a line"
+                      << " for each register)" << std::endl;
+            return 1;
+        }
     }
+    if (!checkOptions(given))
+        return 1;
 
-    else if(lineForm == 'S')
-    {
-        singleLine(totalLost, totalEntered, totalWait, exitedLine, exitedReg,regTime,
-                  leftInLine, simLen, numOfRegs, maxLineLen);
+    if (converting){
+        if (convertTrace(std::cin, std::cout, toBinary))
+            return 0;
+        std::cerr << "couldn't convert the input" << std::endl;
+        return 1;
     }
+    if (!feedPath.empty())
+        return feed(feedPath, feedRate);
+    if (optimizing)
+        return optimize(target, jockeyMargin, numThreads);
+    if (numOfReplicas > 0)
+        return runReplicas(numOfReplicas, seed);
+    if (!cacheDir.empty())
+        return simulateCached(cacheDir, cacheBytes, cacheLog, storage, jockeyMargin, numThreads);
 
-
-    int leftInReg = 0;
-    for (int i = 0; i < numOfRegs; i++){
-        if (regTime[i][0] > 0){
-            leftInReg++;
+    // A live feed is read as it's written, through an epoll-driven buffer
+    FeedBuf feedBuf;
+    std::istream feedIn{&feedBuf};
+    if (!listenPath.empty()){
+        if (!feedBuf.open(listenPath)){
+            std::cerr << "couldn't listen on " << listenPath << ": " << std::strerror(errno) << std::endl;
+            return 1;
         }
+        std::cerr << "waiting for a feed on " << listenPath << std::endl;
     }
 
-    std::cout << std::endl << "STATS" << std::endl;
-    std::cout << "Entered Line    : " << totalEntered << std::endl;
-    std::cout << "Exited Line     : " << exitedLine << std::endl;
-    std::cout << "Exited Register : " << exitedReg << std::endl;
-    std::cout << "Avg Wait Time   : " << std::setprecision(2)<<std::fixed
-              << totalWait/(float)exitedLine << std::endl;
-    std::cout << "Left In Line    : " << leftInLine << std::endl;
-    std::cout << "Left In Register: " << leftInReg << std::endl;
-    std::cout << "Lost            : " << totalLost << std::endl;
+    SimConfig config{};
+    std::vector<int> regTimes;
+    SimStats stats;
+    std::unique_ptr<ArrivalSource> arrivals = readInput(listenPath.empty() ? std::cin : feedIn, config, regTimes);
+    if (!arrivals){
+        std::cerr << "couldn't read the input" << std::endl;
+        return 1;
+    }
+    if (!checkLineForm(config, numThreads, jockeyMargin))
+        return 1;
+    std::unique_ptr<LiveArrivals> live;
+    if (!listenPath.empty())
+        live.reset(new LiveArrivals(*arrivals, stats, std::cout, statsEvery));
+    config.jockeyMargin = jockeyMargin;
+    int regTime[config.numOfRegs][2];
+    makeRegTime(regTime, regTimes);
+
+    std::unique_ptr<Timeline> timeline;
+    if (!timelinePath.empty())
+        timeline.reset(new Timeline(config.numOfRegs, config.lineForm == 'M' ? config.numOfRegs : 1, timelineEvents));
+
+    std::cout << "LOG" << std::endl;
+    std::cout << "0 start" << std::endl;
+
+    simulateLines(storage, config, regTime, live ? *live : *arrivals, std::cout, stats, numThreads, timeline.get());
+    if (live)
+        live->finish();
 
+    printStats(stats, std::cout);
+    if (MemoryAccount::Enabled)
+        printMemory(stats, std::cout);
+    if (live)
+        printFeedStats(live->feedStats(), std::cerr);
+
+    if (timeline && !exportTimeline(*timeline, timelinePath)){
+        std::cerr << "couldn't write the timeline to " << timelinePath << std::endl;
+        return 1;
+    }
     return 0;
 }
 
-// Runs the simulation with a single line to the registers
-void singleLine(int& totalLost, int& totalEntered, int& totalWait, int& exitedLine,
-               int& exitedReg, int regTime[][2], int& leftInLine, int simLen, int numOfRegs, int maxLineLen)
+// Checks that the options given pick at most one mode (a plain simulation
+// if none) and that every other option applies to that mode, so that an
+// option is never silently ignored
+bool checkOptions(const std::set<std::string>& given)
 {
-    Queue<int> line;
-    int timer = 0;
-    int customerCount, customerTime;
-    std::cin >> customerCount >> customerTime;
-
-    while (timer < simLen) {
-        if (customerTime == timer) {
-            for (int i = 0; i < customerCount; i++) {
-                if (line.size() < maxLineLen) {
-                    line.enqueue(timer);
-                    std::cout << timer << " entered line length " << line.size() << std::endl;
-                    totalEntered++;
-                }
-                else{
-                    std::cout << timer << " lost" << std::endl;
-                    totalLost++;
-                }
-            }
-            std::cin >> customerCount >> customerTime;
-        }
+    static const char* const Modes[] = {"--convert", "--feed", "--optimize", "--replicas", "--cache", "--listen"};
+    static const std::set<std::string> PlainOptions = {
+        "--compact-lines", "--unrolled-lines", "--threads", "--jockey", "--timeline", "--timeline-events"
+    };
+    static const std::map<std::string, std::set<std::string>> ModeOptions = {
+        {"", PlainOptions},
+        {"--listen", {"--stats-every", "--compact-lines", "--unrolled-lines", "--threads", "--jockey",
+                      "--timeline", "--timeline-events"}},
+        {"--cache", {"--cache-size", "--cache-log", "--compact-lines", "--unrolled-lines", "--threads", "--jockey"}},
+        {"--optimize", {"--max-lost", "--max-wait", "--threads", "--jockey"}},
+        {"--replicas", {"--seed"}},
+        {"--convert", {}},
+        {"--feed", {"--feed-rate"}},
+    };
 
-        for (int i = 0; i < numOfRegs; i++){
-            if (regTime[i][0] == regTime[i][1]){
-                std::cout << timer << " exited register " << i+1 <<std::endl;
-                regTime[i][0] = 0;
-                exitedReg++;
-            }
+    std::string mode;
+    for (const char* m : Modes){
+        if (given.count(m) == 0)
+            continue;
+        if (!mode.empty()){
+            std::cerr << m << " can't be used with " << mode << std::endl;
+            return false;
+        }
+        mode = m;
+    }
 
-            if (regTime[i][0] == 0 && line.size() > 0){
-                totalWait += timer - line.front();
-                std::cout << timer << " exited line length " << line.size()-1;
-                std::cout << " wait time " << timer-line.front() << std::endl;
-                std::cout << timer << " entered register " << i+1 << std::endl;
-                line.dequeue();
-                regTime[i][0] = 5;
-                exitedLine++;
-            }
-            else if (regTime[i][0] > 0){
-                regTime[i][0] += 5;
+    const std::set<std::string>& options = ModeOptions.at(mode);
+    for (const std::string& option : given){
+        if (option == mode || options.count(option) > 0)
+            continue;
+        if (mode.empty()){
+            for (const auto& modeOptions : ModeOptions){
+                if (modeOptions.second.count(option) > 0){
+                    std::cerr << option << " needs " << modeOptions.first << std::endl;
+                    break;
+                }
             }
-
         }
-
-        timer += 5;
+        else
+            std::cerr << option << " can't be used with " << mode << std::endl;
+        return false;
+    }
+    if (given.count("--compact-lines") > 0 && given.count("--unrolled-lines") > 0){
+        std::cerr << "--compact-lines can't be used with --unrolled-lines" << std::endl;
+        return false;
+    }
+    // Lines that customers jockey between can't be split between threads,
+    // though --optimize's threads each run a whole simulation
+    if (mode != "--optimize" && given.count("--threads") > 0 && given.count("--jockey") > 0){
+        std::cerr << "--threads can't be used with --jockey" << std::endl;
+        return false;
     }
-    std::cout << simLen << " end" << std::endl;
-    leftInLine = line.size();
+    return true;
 }
 
-// Runs the simulation with multiple lines, one for each register
-void multiLine(int& totalLost, int& totalEntered, int& totalWait, int& exitedLine, int& exitedReg,
-               int regTime[][2], int& leftInLine, int simLen, int numOfRegs, int maxLineLen)
+// Checks that the options that only apply to multiple lines aren't used
+// with an input that has a single line, where they'd be silently ignored.
+// This can only be told once the input has been read.
+bool checkLineForm(const SimConfig& config, int numThreads, int jockeyMargin)
 {
-    std::vector<Queue<int>> regs = makeLines(numOfRegs);
-    int timer = 0;
-    int customerCount, customerTime;
-    std::cin >> customerCount >> customerTime;
-
-    while (timer < simLen){
-        if (customerTime == timer){
-            int lostInLine = insertCust(regs, numOfRegs, customerCount, timer, maxLineLen);
-            totalLost += lostInLine;
-            totalEntered += customerCount - lostInLine;
-            std::cin >> customerCount >> customerTime;
-        }
-
-        for (int i = 0; i < numOfRegs; i++){
-            if (regTime[i][0] == regTime[i][1]){
-                std::cout << timer << " exited register " << i+1 <<std::endl;
-                regTime[i][0] = 0;
-                exitedReg++;
-            }
-
-            if (regTime[i][0] == 0 && regs[i].size() > 0){
-                totalWait += timer - regs[i].front();
-                enterReg(regs, timer, regTime, i);
-                exitedLine++;
-            }
-            else if (regTime[i][0] > 0){
-                regTime[i][0] += 5;
-            }
-        }
-        timer += 5;
+    if (config.lineForm == 'M')
+        return true;
+    if (numThreads > 1){
+        std::cerr << "--threads needs an input with a line for each register (M)" << std::endl;
+        return false;
     }
+    if (jockeyMargin > 0){
+        std::cerr << "--jockey needs an input with a line for each register (M)" << std::endl;
+        return false;
+    }
+    return true;
+}
 
-    std::cout << simLen << " end" << std::endl;
+// Parses a positive whole number of megabytes into bytes, or returns false
+// if text isn't one, or is too many megabytes to count in bytes
+bool parseMegabytes(const char* text, unsigned long long& bytes)
+{
+    if (!std::isdigit(static_cast<unsigned char>(text[0])))
+        return false;
+    char* end;
+    errno = 0;
+    unsigned long long megabytes = std::strtoull(text, &end, 10);
+    if (*end != '\0' || errno == ERANGE || megabytes == 0
+        || megabytes > std::numeric_limits<unsigned long long>::max() >> 20)
+        return false;
+    bytes = megabytes << 20;
+    return true;
+}
 
-    for (int i = 0; i < numOfRegs; i++){
-        leftInLine += regs[i].size();
-    }
+// Runs the simulation with lines kept the way the command line chose
+void simulateLines(const LineStorage& storage, const SimConfig& config, int regTime[][2], ArrivalSource& arrivals,
+                   std::ostream& log, SimStats& stats, int numThreads, Timeline* timeline)
+{
+    if (storage.compactLines)
+        simulate<CompactLine>(config, regTime, arrivals, log, stats, numThreads, nullptr, timeline);
+    else if (storage.unrolledLines)
+        simulate<UnrolledLine>(config, regTime, arrivals, log, stats, numThreads, nullptr, timeline);
+    else
+        simulate<Queue<int>>(config, regTime, arrivals, log, stats, numThreads, nullptr, timeline);
 }
 
-// Moves a customer from the line and into the register
-void enterReg(std::vector<Queue<int>>& regs, int timer, int regTime[][2], int i)
+// Writes the timeline to a file in the Chrome trace event format
+bool exportTimeline(const Timeline& timeline, const std::string& path)
 {
-    std::cout << timer << " exited line " << i+1 << " length " << regs[i].size()-1;
-    std::cout << " wait time " << timer-regs[i].front() << std::endl;
-    std::cout << timer << " entered register " << i+1 << std::endl;
-    regs[i].dequeue();
-    regTime[i][0] = 5;
+    std::ofstream out(path);
+    timeline.exportTrace(out);
+    out.close();
+    return bool(out);
 }
 
-// creates a vector that holds all the queues, representing lines
-std::vector<Queue<int>> makeLines(int numOfRegs)
+// Reads the whole input and finds the fewest of its registers that meet
+// the target, trying numThreads register counts at a time
+int optimize(const StaffingTarget& target, int jockeyMargin, int numThreads)
 {
-    std::vector<Queue<int>> regs;
-    for (int i = 0; i < numOfRegs; i++){
-        regs.push_back(Queue<int>());
+    Trace trace;
+    if (!readTrace(std::cin, trace)){
+        std::cerr << "couldn't read the input" << std::endl;
+        return 1;
     }
-    return regs;
+    if (!checkLineForm(trace.config, 1, jockeyMargin))
+        return 1;
+    trace.config.jockeyMargin = jockeyMargin;
+
+    std::vector<StaffingRun> runs = optimizeStaffing(trace, target, numThreads);
+    printStaffing(runs, std::cout);
+    return bestStaffing(runs) != nullptr ? 0 : 2;
 }
 
-// Creates a two dimensional array with:
-// (1) how long customer is in register
-// (2) how long is the process time for the register
-void makeRegTime(int regTime[][2], int numOfRegs)
+// Reads the whole input and writes it to the live feed at feedPath, at
+// feedRate arrivals per second (or as fast as it can if that's 0)
+int feed(const std::string& feedPath, double feedRate)
 {
-    for (int i = 0; i < numOfRegs; i++){
-        regTime[i][0] = 0;
-        std::cin >> regTime[i][1];
+    Trace trace;
+    if (!readTrace(std::cin, trace)){
+        std::cerr << "couldn't read the input" << std::endl;
+        return 1;
+    }
+
+    if (!feedTrace(trace, feedPath, feedRate)){
+        std::cerr << "couldn't feed " << feedPath << ": " << std::strerror(errno) << std::endl;
+        return 1;
     }
+    return 0;
 }
 
-// Determine the shortest line
-// If all the max size then return number of registers
-// Otherwise return the shortest line
-int shortLine(const std::vector<Queue<int>>& regs, int maxLineLen)
+// Reads the whole input and simulates numOfReplicas replicas of it, each
+// with its own random number of customers at each arrival
+int runReplicas(int numOfReplicas, unsigned long long seed)
 {
-    int lineSize = maxLineLen;
-    int shortLine;
-    for (int i = 0; i < regs.size(); i++){
-        if (regs[i].size() < lineSize){
-            lineSize = regs[i].size();
-            shortLine = i;
-        }
+    Trace trace;
+    if (!readTrace(std::cin, trace)){
+        std::cerr << "couldn't read the input" << std::endl;
+        return 1;
     }
-    if (lineSize == maxLineLen)
-        return regs.size();
-    else
-        return shortLine;
+
+    std::vector<ResampledArrivals> streams;
+    std::vector<ArrivalSource*> arrivals;
+    streams.reserve(numOfReplicas);
+    for (int k = 0; k < numOfReplicas; k++){
+        streams.emplace_back(trace, seed, k);
+        arrivals.push_back(&streams.back());
+    }
+
+    std::vector<SimStats> replicas = simulateReplicas(trace.config, trace.regTimes, arrivals);
+    printReplicas(replicas, summarizeReplicas(replicas), std::cout);
+    return 0;
 }
 
-// Insert each of the new customers into the shortest line
-// If all lines are full then inform about a lost customer
-int insertCust(std::vector<Queue<int>>& regs, int numOfRegs,int customerCount, int timer, int maxLineLen){
-    int lost = 0;
-    for (int i = 0; i < customerCount; i++){
-        int line = shortLine(regs, maxLineLen);
-        if (line == numOfRegs){
-            std::cout << timer << " lost" << std::endl;
-            lost++;
-        }
-        else{
-            regs[line].enqueue(timer);
-            std::cout << timer << " entered line " << line+1 << " length " << regs[line].size() << std::endl;
-        }
+// Reads the whole input, hashing it as it goes, and prints the results
+// kept for it in the cache, or simulates it and keeps the results if
+// there aren't any.  Only the STATS are printed unless cacheLog is set,
+// in which case the output is the same as without the cache.  Jockeying
+// changes the results, so its margin is hashed along with the input.
+int simulateCached(const std::string& cacheDir, unsigned long long cacheBytes, bool cacheLog,
+                   const LineStorage& storage, int jockeyMargin, int numThreads)
+{
+    Trace trace;
+    Fnv1aHash hash;
+    if (!readTrace(std::cin, trace, &hash)){
+        std::cerr << "couldn't read the input" << std::endl;
+        return 1;
+    }
+    if (!checkLineForm(trace.config, numThreads, jockeyMargin))
+        return 1;
+    trace.config.jockeyMargin = jockeyMargin;
+    if (jockeyMargin > 0)
+        hash.addInt(jockeyMargin);
+
+    ResultCache cache(cacheDir, cacheBytes);
+    CachedResult result;
+    if (!cache.load(trace, hash.value(), cacheLog, result)){
+        int numOfRegs = trace.config.numOfRegs;
+        std::unique_ptr<int[][2]> regTime{new int[numOfRegs][2]};
+        makeRegTime(regTime.get(), trace.regTimes);
+
+        TraceArrivals arrivals(trace);
+        std::ostringstream log;
+        std::ostream noLog{nullptr};
+        result = CachedResult{};
+        simulateLines(storage, trace.config, regTime.get(), arrivals, cacheLog ? log : noLog, result.stats,
+                      numThreads, nullptr);
+        result.hasLog = cacheLog;
+        result.log = log.str();
+        cache.store(trace, hash.value(), result);
     }
-    return lost;
+
+    if (cacheLog){
+        std::cout << "LOG" << std::endl;
+        std::cout << "0 start" << std::endl;
+        std::cout << result.log;
+    }
+    printStats(result.stats, std::cout);
+    if (MemoryAccount::Enabled && !result.stats.lineMemory.empty())
+        printMemory(result.stats, std::cout);
+    return 0;
 }
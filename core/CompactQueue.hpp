@@ -0,0 +1,537 @@
+// CompactQueue.hpp
+
+#ifndef COMPACTQUEUE_HPP
+#define COMPACTQUEUE_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include "EmptyException.hpp"
+#include "MemoryAccount.hpp"
+
+
+
+// CompactQueue is a first-in, first-out queue of integral values that is
+// meant for long runs of non-decreasing values that are multiples of
+// Quantum, like the arrival timestamps of customers waiting in a line.
+// Rather than one node per value, values are packed into blocks the size
+// of a cache line: each block stores its first value in full and every
+// following one as a one-byte count of Quanta since the value before it.
+// A value that can't be stored that way (it's smaller than the previous
+// one, not a multiple of Quantum away from it, or too far ahead of it)
+// simply starts a new block, so any sequence of values is accepted.
+template <typename ValueType, ValueType Quantum = 1>
+class CompactQueue : private MemoryAccount
+{
+private:
+    struct Block;
+
+
+public:
+    class ConstStlIterator;
+
+    using value_type = ValueType;
+    using const_iterator = ConstStlIterator;
+
+    // Initializes this queue to be empty.
+    CompactQueue() noexcept;
+
+    // Initializes this queue as a copy of an existing one.
+    CompactQueue(const CompactQueue& queue);
+
+    // Initializes this queue from an expiring one.
+    CompactQueue(CompactQueue&& queue) noexcept;
+
+
+    // Destroys the contents of this queue.
+    ~CompactQueue() noexcept;
+
+
+    // Replaces the contents of this queue with a copy of the contents
+    // of an existing one.
+    CompactQueue& operator=(const CompactQueue& queue);
+
+    // Replaces the contents of this queue with the contents of an
+    // expiring one.
+    CompactQueue& operator=(CompactQueue&& queue) noexcept;
+
+
+    // enqueue() adds a value to the back of the queue.
+    void enqueue(const ValueType& value);
+
+
+    // dequeue() removes the value at the front of the queue.  In the
+    // event that the queue is empty, an EmptyException will be thrown.
+    void dequeue();
+
+
+    // front() returns the value at the front of the queue.  In the event
+    // that the queue is empty, an EmptyException will be thrown.
+    const ValueType& front() const;
+
+
+    // tryDequeue() and tryFront() do the same as dequeue() and front(),
+    // except that they never throw: tryDequeue() returns false if the
+    // queue was empty, and tryFront() returns a pointer to the front value,
+    // or nullptr if there isn't one.
+    bool tryDequeue() noexcept;
+    const ValueType* tryFront() const noexcept;
+
+
+    // tryDequeueBack() and tryBack() are the same, but for the value at
+    // the back of the queue.  Taking values off the back is O(1) too: the
+    // blocks are linked both ways, and the value before the back one is at
+    // most a block's worth of deltas away.
+    bool tryDequeueBack() noexcept;
+    const ValueType* tryBack() const noexcept;
+
+
+    // isEmpty() returns true if the queue has no values in it, false
+    // otherwise.
+    bool isEmpty() const noexcept;
+
+
+    // size() returns the number of values in the queue.
+    unsigned int size() const noexcept;
+
+
+    // memory() returns what the queue has allocated, if memory accounting
+    // is compiled in (see MemoryAccount.hpp).  The spare block counts.
+    using MemoryAccount::memory;
+
+
+    // begin() and end() return standard forward iterators that decode the
+    // values from front to back, so that the queue can be used with
+    // range-based for loops and the standard algorithms.  The values are
+    // decoded on the fly, so there's nothing to refer to: dereferencing
+    // returns each value by value (reference is ValueType), and there's no
+    // operator->.  An iterator is invalidated by any change to the queue.
+    ConstStlIterator begin() const noexcept;
+    ConstStlIterator end() const noexcept;
+    ConstStlIterator cbegin() const noexcept;
+    ConstStlIterator cend() const noexcept;
+
+
+public:
+    class ConstStlIterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = ValueType;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = ValueType;
+
+        // Initializes a newly-constructed ConstStlIterator to not refer
+        // to any queue; it can only be assigned to.
+        ConstStlIterator() noexcept = default;
+
+        ValueType operator*() const noexcept;
+
+        ConstStlIterator& operator++() noexcept;
+        ConstStlIterator operator++(int) noexcept;
+
+        bool operator==(const ConstStlIterator& other) const noexcept;
+        bool operator!=(const ConstStlIterator& other) const noexcept;
+
+    private:
+        friend class CompactQueue;
+
+        ConstStlIterator(const Block* block, unsigned short index, const ValueType& value) noexcept;
+
+        // The end() position is a nullptr block.
+        const Block* block = nullptr;
+        unsigned short index = 0;
+        ValueType value{};
+    };
+
+
+private:
+    static constexpr unsigned int BlockBytes = 64;
+    static constexpr ValueType MaxDelta = 255;
+
+    // A block holds up to Capacity values: the first one in base, and the
+    // value at index i > 0 as the value at index i - 1 plus
+    // deltas[i] * Quantum (deltas[0] is unused).
+    struct Block
+    {
+        static constexpr unsigned int Capacity =
+            BlockBytes - 2 * sizeof(Block*) - sizeof(ValueType) - sizeof(unsigned short);
+
+        Block* next = nullptr;
+        Block* prev = nullptr;
+        ValueType base;
+        unsigned short count = 0;
+        unsigned char deltas[Capacity];
+    };
+
+    // front() and enqueue() need the absolute values at either end of the
+    // queue, so both are kept decoded rather than recomputed.  One emptied
+    // block is kept as a spare so that a line that keeps going between
+    // empty and non-empty doesn't allocate on every customer.
+    Block* head = nullptr;
+    Block* tail = nullptr;
+    Block* spare = nullptr;
+    unsigned short headIndex = 0;
+    ValueType frontValue{};
+    ValueType backValue{};
+    unsigned int qSize = 0;
+
+    Block* newBlock(const ValueType& value);
+    void releaseBlock(Block* block) noexcept;
+    void deleteBlocks() noexcept;
+    void copyQueue(const CompactQueue& queue);
+    void swap(CompactQueue& queue) noexcept;
+};
+
+
+
+template <typename ValueType, ValueType Quantum>
+CompactQueue<ValueType, Quantum>::CompactQueue() noexcept
+{
+}
+
+
+template <typename ValueType, ValueType Quantum>
+CompactQueue<ValueType, Quantum>::CompactQueue(const CompactQueue& queue)
+{
+    copyQueue(queue);
+}
+
+
+template <typename ValueType, ValueType Quantum>
+CompactQueue<ValueType, Quantum>::CompactQueue(CompactQueue&& queue) noexcept
+{
+    swap(queue);
+}
+
+
+template <typename ValueType, ValueType Quantum>
+CompactQueue<ValueType, Quantum>::~CompactQueue() noexcept
+{
+    deleteBlocks();
+}
+
+
+template <typename ValueType, ValueType Quantum>
+CompactQueue<ValueType, Quantum>& CompactQueue<ValueType, Quantum>::operator=(const CompactQueue& queue)
+{
+    if (this != &queue){
+        CompactQueue copy{queue};
+        swap(copy);
+    }
+    return *this;
+}
+
+
+template <typename ValueType, ValueType Quantum>
+CompactQueue<ValueType, Quantum>& CompactQueue<ValueType, Quantum>::operator=(CompactQueue&& queue) noexcept
+{
+    swap(queue);
+    return *this;
+}
+
+
+template <typename ValueType, ValueType Quantum>
+void CompactQueue<ValueType, Quantum>::enqueue(const ValueType& value)
+{
+    if (tail != nullptr && tail->count < Block::Capacity && value >= backValue){
+        ValueType delta = value - backValue;
+        if (delta % Quantum == 0 && delta / Quantum <= MaxDelta){
+            tail->deltas[tail->count++] = static_cast<unsigned char>(delta / Quantum);
+            backValue = value;
+            qSize++;
+            counted(qSize);
+            return;
+        }
+    }
+
+    Block* block = newBlock(value);
+    if (tail == nullptr){
+        head = block;
+        headIndex = 0;
+        frontValue = value;
+    }
+    else{
+        tail->next = block;
+        block->prev = tail;
+    }
+    tail = block;
+    backValue = value;
+    qSize++;
+    counted(qSize);
+}
+
+
+template <typename ValueType, ValueType Quantum>
+void CompactQueue<ValueType, Quantum>::dequeue()
+{
+    if (!tryDequeue())
+        throw EmptyException();
+}
+
+
+template <typename ValueType, ValueType Quantum>
+bool CompactQueue<ValueType, Quantum>::tryDequeue() noexcept
+{
+    if (head == nullptr)
+        return false;
+
+    headIndex++;
+    qSize--;
+    if (headIndex < head->count){
+        frontValue += head->deltas[headIndex] * Quantum;
+    }
+    else{
+        Block* old = head;
+        head = head->next;
+        headIndex = 0;
+        releaseBlock(old);
+        if (head == nullptr){
+            tail = nullptr;
+        }
+        else{
+            head->prev = nullptr;
+            frontValue = head->base;
+        }
+    }
+    return true;
+}
+
+
+template <typename ValueType, ValueType Quantum>
+bool CompactQueue<ValueType, Quantum>::tryDequeueBack() noexcept
+{
+    if (tail == nullptr)
+        return false;
+
+    qSize--;
+    unsigned short first = tail == head ? headIndex : 0;
+    if (tail->count - 1 > first){
+        tail->count--;
+        backValue -= tail->deltas[tail->count] * Quantum;
+    }
+    else if (tail == head){
+        releaseBlock(tail);
+        head = nullptr;
+        tail = nullptr;
+        headIndex = 0;
+    }
+    else{
+        Block* old = tail;
+        tail = tail->prev;
+        tail->next = nullptr;
+        releaseBlock(old);
+
+        backValue = tail == head ? frontValue : tail->base;
+        for (unsigned short i = tail == head ? headIndex + 1 : 1; i < tail->count; i++)
+            backValue += tail->deltas[i] * Quantum;
+    }
+    return true;
+}
+
+
+template <typename ValueType, ValueType Quantum>
+const ValueType& CompactQueue<ValueType, Quantum>::front() const
+{
+    if (head == nullptr)
+        throw EmptyException();
+    else
+        return frontValue;
+}
+
+
+template <typename ValueType, ValueType Quantum>
+const ValueType* CompactQueue<ValueType, Quantum>::tryFront() const noexcept
+{
+    return head != nullptr ? &frontValue : nullptr;
+}
+
+
+template <typename ValueType, ValueType Quantum>
+const ValueType* CompactQueue<ValueType, Quantum>::tryBack() const noexcept
+{
+    return tail != nullptr ? &backValue : nullptr;
+}
+
+
+template <typename ValueType, ValueType Quantum>
+bool CompactQueue<ValueType, Quantum>::isEmpty() const noexcept
+{
+    return qSize == 0;
+}
+
+
+template <typename ValueType, ValueType Quantum>
+unsigned int CompactQueue<ValueType, Quantum>::size() const noexcept
+{
+    return qSize;
+}
+
+
+template <typename ValueType, ValueType Quantum>
+typename CompactQueue<ValueType, Quantum>::ConstStlIterator CompactQueue<ValueType, Quantum>::begin() const noexcept
+{
+    return ConstStlIterator{head, headIndex, frontValue};
+}
+
+
+template <typename ValueType, ValueType Quantum>
+typename CompactQueue<ValueType, Quantum>::ConstStlIterator CompactQueue<ValueType, Quantum>::end() const noexcept
+{
+    return ConstStlIterator{nullptr, 0, ValueType{}};
+}
+
+
+template <typename ValueType, ValueType Quantum>
+typename CompactQueue<ValueType, Quantum>::ConstStlIterator CompactQueue<ValueType, Quantum>::cbegin() const noexcept
+{
+    return begin();
+}
+
+
+template <typename ValueType, ValueType Quantum>
+typename CompactQueue<ValueType, Quantum>::ConstStlIterator CompactQueue<ValueType, Quantum>::cend() const noexcept
+{
+    return end();
+}
+
+
+template <typename ValueType, ValueType Quantum>
+CompactQueue<ValueType, Quantum>::ConstStlIterator::ConstStlIterator(
+    const Block* block, unsigned short index, const ValueType& value) noexcept
+    : block{block}, index{index}, value{value}
+{
+}
+
+
+template <typename ValueType, ValueType Quantum>
+ValueType CompactQueue<ValueType, Quantum>::ConstStlIterator::operator*() const noexcept
+{
+    return value;
+}
+
+
+template <typename ValueType, ValueType Quantum>
+typename CompactQueue<ValueType, Quantum>::ConstStlIterator&
+CompactQueue<ValueType, Quantum>::ConstStlIterator::operator++() noexcept
+{
+    index++;
+    if (index < block->count){
+        value += block->deltas[index] * Quantum;
+    }
+    else{
+        block = block->next;
+        index = 0;
+        if (block != nullptr)
+            value = block->base;
+    }
+    return *this;
+}
+
+
+template <typename ValueType, ValueType Quantum>
+typename CompactQueue<ValueType, Quantum>::ConstStlIterator
+CompactQueue<ValueType, Quantum>::ConstStlIterator::operator++(int) noexcept
+{
+    ConstStlIterator old = *this;
+    ++*this;
+    return old;
+}
+
+
+template <typename ValueType, ValueType Quantum>
+bool CompactQueue<ValueType, Quantum>::ConstStlIterator::operator==(const ConstStlIterator& other) const noexcept
+{
+    return block == other.block && index == other.index;
+}
+
+
+template <typename ValueType, ValueType Quantum>
+bool CompactQueue<ValueType, Quantum>::ConstStlIterator::operator!=(const ConstStlIterator& other) const noexcept
+{
+    return !(*this == other);
+}
+
+
+template <typename ValueType, ValueType Quantum>
+typename CompactQueue<ValueType, Quantum>::Block* CompactQueue<ValueType, Quantum>::newBlock(const ValueType& value)
+{
+    Block* block = spare;
+    if (block != nullptr){
+        spare = nullptr;
+    }
+    else{
+        block = new Block;
+        allocated(sizeof(Block));
+    }
+
+    block->next = nullptr;
+    block->prev = nullptr;
+    block->base = value;
+    block->count = 1;
+    return block;
+}
+
+
+template <typename ValueType, ValueType Quantum>
+void CompactQueue<ValueType, Quantum>::releaseBlock(Block* block) noexcept
+{
+    if (spare == nullptr){
+        spare = block;
+    }
+    else{
+        freed(sizeof(Block));
+        delete block;
+    }
+}
+
+
+template <typename ValueType, ValueType Quantum>
+void CompactQueue<ValueType, Quantum>::deleteBlocks() noexcept
+{
+    while (head != nullptr){
+        Block* next = head->next;
+        freed(sizeof(Block));
+        delete head;
+        head = next;
+    }
+    if (spare != nullptr)
+        freed(sizeof(Block));
+    delete spare;
+    tail = nullptr;
+    spare = nullptr;
+    headIndex = 0;
+    qSize = 0;
+}
+
+
+template <typename ValueType, ValueType Quantum>
+void CompactQueue<ValueType, Quantum>::copyQueue(const CompactQueue& queue)
+{
+    try{
+        for (const ValueType& value : queue)
+            enqueue(value);
+    }catch(...){
+        deleteBlocks();
+        throw;
+    }
+}
+
+
+template <typename ValueType, ValueType Quantum>
+void CompactQueue<ValueType, Quantum>::swap(CompactQueue& queue) noexcept
+{
+    std::swap(head, queue.head);
+    std::swap(tail, queue.tail);
+    std::swap(spare, queue.spare);
+    std::swap(headIndex, queue.headIndex);
+    std::swap(frontValue, queue.frontValue);
+    std::swap(backValue, queue.backValue);
+    std::swap(qSize, queue.qSize);
+    swapAccount(queue);
+}
+
+
+
+#endif
@@ -1,16 +1,28 @@
 #ifndef DOUBLYLINKEDLIST_HPP
 #define DOUBLYLINKEDLIST_HPP
 
+#include <cstddef>
+#include <iterator>
 #include "EmptyException.hpp"
 #include "IteratorException.hpp"
+#include "MemoryAccount.hpp"
 
 
 template <typename ValueType>
-class DoublyLinkedList
+class DoublyLinkedList : private MemoryAccount
 {
 public:
     class Iterator;
     class ConstIterator;
+    class StlIterator;
+    class ConstStlIterator;
+
+    using value_type = ValueType;
+    using size_type = unsigned int;
+    using difference_type = std::ptrdiff_t;
+    using reference = ValueType&;
+    using const_reference = const ValueType&;
+    using const_iterator = ConstStlIterator;
 
 private:
     struct Node;
@@ -64,6 +76,14 @@ public:
     void removeFromEnd();
 
 
+    // tryRemoveFromStart() and tryRemoveFromEnd() do the same as
+    // removeFromStart() and removeFromEnd(), except that they never throw:
+    // they return true if they removed a value and false if the list was
+    // empty.
+    bool tryRemoveFromStart() noexcept;
+    bool tryRemoveFromEnd() noexcept;
+
+
     // first() returns the value at the start of the list.  In the event that
     // the list is empty, an EmptyException will be thrown.  There are two
     // variants of this member function: one for a const DoublyLinkedList and
@@ -80,6 +100,15 @@ public:
     ValueType& last();
 
 
+    // tryFirst() and tryLast() return a pointer to the value that first()
+    // and last() would return, or nullptr (rather than throwing) if the list
+    // is empty.
+    const ValueType* tryFirst() const noexcept;
+    ValueType* tryFirst() noexcept;
+    const ValueType* tryLast() const noexcept;
+    ValueType* tryLast() noexcept;
+
+
     // isEmpty() returns true if the list has no values in it, false
     // otherwise.
     bool isEmpty() const noexcept;
@@ -88,11 +117,31 @@ public:
     // size() returns the number of values in the list.
     unsigned int size() const noexcept;
 
+
+    // memory() returns what the list has allocated, if memory accounting
+    // is compiled in (see MemoryAccount.hpp).
+    using MemoryAccount::memory;
+
     Iterator iterator();
 
     ConstIterator constIterator() const;
 
 
+    // begin() and end() return standard bidirectional iterators referring
+    // to the first value and to the position after the last value, so
+    // that the list can be used with range-based for loops and the
+    // algorithms in <algorithm> and <numeric>.  Unlike Iterator and
+    // ConstIterator, these don't check anything: dereferencing end(), or
+    // moving past either end, is undefined, just as it is for the
+    // standard containers.  cbegin() and cend() are the const variants.
+    StlIterator begin() noexcept;
+    StlIterator end() noexcept;
+    ConstStlIterator begin() const noexcept;
+    ConstStlIterator end() const noexcept;
+    ConstStlIterator cbegin() const noexcept;
+    ConstStlIterator cend() const noexcept;
+
+
 public:
     class IteratorBase
     {
@@ -192,6 +241,81 @@ public:
     };
 
 
+    class StlIterator
+    {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = ValueType;
+        using difference_type = std::ptrdiff_t;
+        using pointer = ValueType*;
+        using reference = ValueType&;
+
+        // Initializes a newly-constructed StlIterator to not refer to
+        // any list; it can only be assigned to.
+        StlIterator() noexcept = default;
+
+        ValueType& operator*() const noexcept;
+        ValueType* operator->() const noexcept;
+
+        StlIterator& operator++() noexcept;
+        StlIterator operator++(int) noexcept;
+        StlIterator& operator--() noexcept;
+        StlIterator operator--(int) noexcept;
+
+        bool operator==(const StlIterator& other) const noexcept;
+        bool operator!=(const StlIterator& other) const noexcept;
+
+    private:
+        friend class DoublyLinkedList;
+        friend class ConstStlIterator;
+
+        StlIterator(Node* node, const DoublyLinkedList* list) noexcept;
+
+        // The end() position is a nullptr node; the list is only needed
+        // to step back from it to the tail.
+        Node* node = nullptr;
+        const DoublyLinkedList* list = nullptr;
+    };
+
+
+    class ConstStlIterator
+    {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = ValueType;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const ValueType*;
+        using reference = const ValueType&;
+
+        // Initializes a newly-constructed ConstStlIterator to not refer
+        // to any list; it can only be assigned to.
+        ConstStlIterator() noexcept = default;
+
+        // Initializes a newly-constructed ConstStlIterator to refer to
+        // the same position as a non-const one.
+        ConstStlIterator(const StlIterator& iterator) noexcept;
+
+        const ValueType& operator*() const noexcept;
+        const ValueType* operator->() const noexcept;
+
+        ConstStlIterator& operator++() noexcept;
+        ConstStlIterator operator++(int) noexcept;
+        ConstStlIterator& operator--() noexcept;
+        ConstStlIterator operator--(int) noexcept;
+
+        bool operator==(const ConstStlIterator& other) const noexcept;
+        bool operator!=(const ConstStlIterator& other) const noexcept;
+
+    private:
+        friend class DoublyLinkedList;
+
+        ConstStlIterator(const Node* node, const DoublyLinkedList* list) noexcept;
+
+        const Node* node = nullptr;
+        const DoublyLinkedList* list = nullptr;
+    };
+
+
 private:
     // A structure that contains the vital parts of a Node in a
     // doubly-linked list, the value and two pointers: one pointing
@@ -214,6 +338,8 @@ private:
     void deleteList();
     void copyList(const DoublyLinkedList& list);
     void removeNode(Node* rmv_node);
+    Node* newNode();
+    void deleteNode(Node* node) noexcept;
 };
 
 
@@ -245,6 +371,7 @@ DoublyLinkedList<ValueType>::DoublyLinkedList(DoublyLinkedList&& list) noexcept
 	int tempQ = qSize;
 	qSize = list.qSize;
 	list.qSize = tempQ;
+	swapAccount(list);
 }
 
 
@@ -254,9 +381,9 @@ DoublyLinkedList<ValueType>::~DoublyLinkedList() noexcept
 	if (head != nullptr){
 		while(head->next != nullptr){
 			head = head->next;
-			delete head->prev;
+			deleteNode(head->prev);
 		}
-		delete head;
+		deleteNode(head);
 	}
 }
 
@@ -264,8 +391,10 @@ DoublyLinkedList<ValueType>::~DoublyLinkedList() noexcept
 template <typename ValueType>
 DoublyLinkedList<ValueType>& DoublyLinkedList<ValueType>::operator=(const DoublyLinkedList& list)
 {
-	deleteList();
-	copyList(list);
+	if (this != &list){
+		deleteList();
+		copyList(list);
+	}
     return *this;
 }
 
@@ -284,6 +413,7 @@ DoublyLinkedList<ValueType>& DoublyLinkedList<ValueType>::operator=(DoublyLinked
 	int tempQ = qSize;
 	qSize = list.qSize;
 	list.qSize = tempQ;
+	swapAccount(list);
     return *this;
 }
 
@@ -293,7 +423,7 @@ void DoublyLinkedList<ValueType>::addToStart(const ValueType& value)
 {
 	Node* nodePtr = nullptr;
 	try{
-		nodePtr = new Node;
+		nodePtr = newNode();
 		if (head == nullptr){
 		head = nodePtr;
 		tail = nodePtr;
@@ -306,8 +436,9 @@ void DoublyLinkedList<ValueType>::addToStart(const ValueType& value)
 			head = head->prev;
 		}
 		qSize++;
+		counted(qSize);
 	}catch(...){
-		delete nodePtr;
+		deleteNode(nodePtr);
 		throw;
 	}
 }
@@ -318,7 +449,7 @@ void DoublyLinkedList<ValueType>::addToEnd(const ValueType& value)
 {
 	Node *nodePtr = nullptr;
 	try{
-		nodePtr = new Node;
+		nodePtr = newNode();
 		if (tail == nullptr){
 			head = nodePtr;
 			tail = nodePtr;
@@ -331,8 +462,9 @@ void DoublyLinkedList<ValueType>::addToEnd(const ValueType& value)
 			tail = tail->next;
 		}
 		qSize++;
+		counted(qSize);
 	}catch(...){
-		delete nodePtr;
+		deleteNode(nodePtr);
 		throw;
 	}
 }
@@ -341,44 +473,58 @@ void DoublyLinkedList<ValueType>::addToEnd(const ValueType& value)
 template <typename ValueType>
 void DoublyLinkedList<ValueType>::removeFromStart()
 {
-	if (head != nullptr){
-		if (head->next != nullptr){
-			head = head->next;
-			delete head->prev;
-			head->prev = nullptr;
-		}
-		else{
-			delete head;
-			head = nullptr;
-			tail = nullptr;
-		}
-		qSize--;
+	if (!tryRemoveFromStart())
+		throw EmptyException();
+}
+
+
+template <typename ValueType>
+void DoublyLinkedList<ValueType>::removeFromEnd()
+{
+	if (!tryRemoveFromEnd())
+		throw EmptyException();
+}
+
+
+template <typename ValueType>
+bool DoublyLinkedList<ValueType>::tryRemoveFromStart() noexcept
+{
+	if (head == nullptr)
+		return false;
+
+	if (head->next != nullptr){
+		head = head->next;
+		deleteNode(head->prev);
+		head->prev = nullptr;
 	}
 	else{
-		throw EmptyException();
+		deleteNode(head);
+		head = nullptr;
+		tail = nullptr;
 	}
+	qSize--;
+	return true;
 }
 
 
 template <typename ValueType>
-void DoublyLinkedList<ValueType>::removeFromEnd()
+bool DoublyLinkedList<ValueType>::tryRemoveFromEnd() noexcept
 {
-	if (tail != nullptr){
-		if (tail->prev != nullptr){
-			tail = tail->prev;
-			delete tail->next;
-			tail->next = nullptr;
-		}
-		else{
-			delete tail;
-			head = nullptr;
-			tail = nullptr;
-		}
-		qSize--;
+	if (tail == nullptr)
+		return false;
+
+	if (tail->prev != nullptr){
+		tail = tail->prev;
+		deleteNode(tail->next);
+		tail->next = nullptr;
 	}
 	else{
-		throw EmptyException();
+		deleteNode(tail);
+		head = nullptr;
+		tail = nullptr;
 	}
+	qSize--;
+	return true;
 }
 
 
@@ -422,6 +568,34 @@ ValueType& DoublyLinkedList<ValueType>::last()
 }
 
 
+template <typename ValueType>
+const ValueType* DoublyLinkedList<ValueType>::tryFirst() const noexcept
+{
+	return head != nullptr ? &head->value : nullptr;
+}
+
+
+template <typename ValueType>
+ValueType* DoublyLinkedList<ValueType>::tryFirst() noexcept
+{
+	return head != nullptr ? &head->value : nullptr;
+}
+
+
+template <typename ValueType>
+const ValueType* DoublyLinkedList<ValueType>::tryLast() const noexcept
+{
+	return tail != nullptr ? &tail->value : nullptr;
+}
+
+
+template <typename ValueType>
+ValueType* DoublyLinkedList<ValueType>::tryLast() noexcept
+{
+	return tail != nullptr ? &tail->value : nullptr;
+}
+
+
 template <typename ValueType>
 unsigned int DoublyLinkedList<ValueType>::size() const noexcept
 {
@@ -450,8 +624,51 @@ typename DoublyLinkedList<ValueType>::ConstIterator DoublyLinkedList<ValueType>:
 }
 
 
+template <typename ValueType>
+typename DoublyLinkedList<ValueType>::StlIterator DoublyLinkedList<ValueType>::begin() noexcept
+{
+    return StlIterator{head, this};
+}
+
+
+template <typename ValueType>
+typename DoublyLinkedList<ValueType>::StlIterator DoublyLinkedList<ValueType>::end() noexcept
+{
+    return StlIterator{nullptr, this};
+}
+
+
+template <typename ValueType>
+typename DoublyLinkedList<ValueType>::ConstStlIterator DoublyLinkedList<ValueType>::begin() const noexcept
+{
+    return ConstStlIterator{head, this};
+}
+
+
+template <typename ValueType>
+typename DoublyLinkedList<ValueType>::ConstStlIterator DoublyLinkedList<ValueType>::end() const noexcept
+{
+    return ConstStlIterator{nullptr, this};
+}
+
+
+template <typename ValueType>
+typename DoublyLinkedList<ValueType>::ConstStlIterator DoublyLinkedList<ValueType>::cbegin() const noexcept
+{
+    return begin();
+}
+
+
+template <typename ValueType>
+typename DoublyLinkedList<ValueType>::ConstStlIterator DoublyLinkedList<ValueType>::cend() const noexcept
+{
+    return end();
+}
+
+
 template <typename ValueType>
 DoublyLinkedList<ValueType>::IteratorBase::IteratorBase(const DoublyLinkedList& list) noexcept
+    : plist{const_cast<DoublyLinkedList*>(&list)}
 {
 }
 
@@ -459,13 +676,12 @@ DoublyLinkedList<ValueType>::IteratorBase::IteratorBase(const DoublyLinkedList&
 template <typename ValueType>
 void DoublyLinkedList<ValueType>::IteratorBase::moveToNext()
 {
-	if (this->isPastStart()){
-		pastStart = false;
-		current = current->next;
-	}
-	else if (this->isPastEnd()){
+	if (this->isPastEnd()){
 		throw IteratorException();
 	}
+	else if (this->isPastStart()){
+		pastStart = false;
+	}
 	else{
 		if (this->current->next == nullptr)
 			pastEnd = true;
@@ -479,13 +695,12 @@ void DoublyLinkedList<ValueType>::IteratorBase::moveToNext()
 template <typename ValueType>
 void DoublyLinkedList<ValueType>::IteratorBase::moveToPrevious()
 {
-	if (this->isPastEnd()){
-		pastEnd = false;
-		current = current->prev;
-	}
-	else if (this->isPastStart()){
+	if (this->isPastStart()){
 		throw IteratorException();
 	}
+	else if (this->isPastEnd()){
+		pastEnd = false;
+	}
 	else{
 		if (current->prev == nullptr)
 			pastStart = true;
@@ -565,16 +780,20 @@ void DoublyLinkedList<ValueType>::Iterator::insertBefore(const ValueType& value)
 {
 	if (this->isPastStart())
 		throw IteratorException();
+	else if (this->isPastEnd()){
+		this->plist->addToEnd(value);
+		this->current = this->plist->tail;
+	}
 	else if (this->current->prev == nullptr){
 		this->plist->addToStart(value);
 	}
 	else{
 		Node* nodePtr = nullptr;
 		try{
-			nodePtr = new Node;
+			nodePtr = this->plist->newNode();
 		}
 		catch(...){
-			delete nodePtr;
+			this->plist->deleteNode(nodePtr);
 			throw;
 		}
 		this->current->prev->next = nodePtr;
@@ -583,6 +802,7 @@ void DoublyLinkedList<ValueType>::Iterator::insertBefore(const ValueType& value)
 		this->current->prev = this->current->prev->next;
 		this->current->prev->value = value;
 		this->plist->qSize++;
+		this->plist->counted(this->plist->qSize);
 		}
 }
 
@@ -592,16 +812,21 @@ void DoublyLinkedList<ValueType>::Iterator::insertAfter(const ValueType& value)
 {
 	if (this->isPastEnd())
 		throw IteratorException();
+	else if (this->isPastStart()){
+		this->plist->addToStart(value);
+		this->current = this->plist->head;
+	}
 	else if (this->current->next == nullptr){
 		this->plist->addToEnd(value);
 	}
 	else{
-		this->current->next->prev = new Node;
+		this->current->next->prev = this->plist->newNode();
 		this->current->next->prev->prev = this->current;
 		this->current->next->prev->next = this->current->next;
 		this->current->next = this->current->next->prev;
 		this->current->next->value = value;
 		this->plist->qSize++;
+		this->plist->counted(this->plist->qSize);
 		}
 }
 
@@ -609,46 +834,198 @@ void DoublyLinkedList<ValueType>::Iterator::insertAfter(const ValueType& value)
 template <typename ValueType>
 void DoublyLinkedList<ValueType>::Iterator::remove(bool moveToNextAfterward)
 {
-	if (this->current == nullptr)
+	if (this->isPastStart() || this->isPastEnd())
 		throw IteratorException();
-	else if (this->current->next == nullptr){
-		this->plist->removeNode(this->current);
-		this->current = this->plist->tail;
+
+	Node* prev = this->current->prev;
+	Node* next = this->current->next;
+	this->plist->removeNode(this->current);
+
+	if (this->plist->head == nullptr){
+		this->current = nullptr;
+		this->pastStart = true;
+		this->pastEnd = true;
 	}
-	else if (this->current->prev == nullptr){
-		this->plist->removeNode(this->current);
-		this->current = this->plist->head;
+	else if (moveToNextAfterward){
+		if (next != nullptr)
+			this->current = next;
+		else{
+			this->current = prev;
+			this->pastEnd = true;
+		}
 	}
 	else{
-		if (moveToNextAfterward){
-			this->current = this->current->next;
-			this->current->prev = this->current->prev->prev;
-			delete this->current->prev->next;
-			this->current->prev->next = this->current;
-		}
+		if (prev != nullptr)
+			this->current = prev;
 		else{
-			this->current = this->current->prev;
-			this->current->next = this->current->next->next;
-			delete this->current->next->prev;
-			this->current->next->prev = this->current;
+			this->current = next;
+			this->pastStart = true;
 		}
 	}
 }
 
+
+template <typename ValueType>
+DoublyLinkedList<ValueType>::StlIterator::StlIterator(Node* node, const DoublyLinkedList* list) noexcept
+    : node{node}, list{list}
+{
+}
+
+
+template <typename ValueType>
+ValueType& DoublyLinkedList<ValueType>::StlIterator::operator*() const noexcept
+{
+    return node->value;
+}
+
+
+template <typename ValueType>
+ValueType* DoublyLinkedList<ValueType>::StlIterator::operator->() const noexcept
+{
+    return &node->value;
+}
+
+
+template <typename ValueType>
+typename DoublyLinkedList<ValueType>::StlIterator& DoublyLinkedList<ValueType>::StlIterator::operator++() noexcept
+{
+    node = node->next;
+    return *this;
+}
+
+
+template <typename ValueType>
+typename DoublyLinkedList<ValueType>::StlIterator DoublyLinkedList<ValueType>::StlIterator::operator++(int) noexcept
+{
+    StlIterator old = *this;
+    node = node->next;
+    return old;
+}
+
+
+template <typename ValueType>
+typename DoublyLinkedList<ValueType>::StlIterator& DoublyLinkedList<ValueType>::StlIterator::operator--() noexcept
+{
+    node = node == nullptr ? list->tail : node->prev;
+    return *this;
+}
+
+
+template <typename ValueType>
+typename DoublyLinkedList<ValueType>::StlIterator DoublyLinkedList<ValueType>::StlIterator::operator--(int) noexcept
+{
+    StlIterator old = *this;
+    --*this;
+    return old;
+}
+
+
+template <typename ValueType>
+bool DoublyLinkedList<ValueType>::StlIterator::operator==(const StlIterator& other) const noexcept
+{
+    return node == other.node;
+}
+
+
+template <typename ValueType>
+bool DoublyLinkedList<ValueType>::StlIterator::operator!=(const StlIterator& other) const noexcept
+{
+    return node != other.node;
+}
+
+
+template <typename ValueType>
+DoublyLinkedList<ValueType>::ConstStlIterator::ConstStlIterator(const Node* node, const DoublyLinkedList* list) noexcept
+    : node{node}, list{list}
+{
+}
+
+
+template <typename ValueType>
+DoublyLinkedList<ValueType>::ConstStlIterator::ConstStlIterator(const StlIterator& iterator) noexcept
+    : node{iterator.node}, list{iterator.list}
+{
+}
+
+
+template <typename ValueType>
+const ValueType& DoublyLinkedList<ValueType>::ConstStlIterator::operator*() const noexcept
+{
+    return node->value;
+}
+
+
+template <typename ValueType>
+const ValueType* DoublyLinkedList<ValueType>::ConstStlIterator::operator->() const noexcept
+{
+    return &node->value;
+}
+
+
+template <typename ValueType>
+typename DoublyLinkedList<ValueType>::ConstStlIterator& DoublyLinkedList<ValueType>::ConstStlIterator::operator++() noexcept
+{
+    node = node->next;
+    return *this;
+}
+
+
+template <typename ValueType>
+typename DoublyLinkedList<ValueType>::ConstStlIterator DoublyLinkedList<ValueType>::ConstStlIterator::operator++(int) noexcept
+{
+    ConstStlIterator old = *this;
+    node = node->next;
+    return old;
+}
+
+
+template <typename ValueType>
+typename DoublyLinkedList<ValueType>::ConstStlIterator& DoublyLinkedList<ValueType>::ConstStlIterator::operator--() noexcept
+{
+    node = node == nullptr ? list->tail : node->prev;
+    return *this;
+}
+
+
+template <typename ValueType>
+typename DoublyLinkedList<ValueType>::ConstStlIterator DoublyLinkedList<ValueType>::ConstStlIterator::operator--(int) noexcept
+{
+    ConstStlIterator old = *this;
+    --*this;
+    return old;
+}
+
+
+template <typename ValueType>
+bool DoublyLinkedList<ValueType>::ConstStlIterator::operator==(const ConstStlIterator& other) const noexcept
+{
+    return node == other.node;
+}
+
+
+template <typename ValueType>
+bool DoublyLinkedList<ValueType>::ConstStlIterator::operator!=(const ConstStlIterator& other) const noexcept
+{
+    return node != other.node;
+}
+
+
 template <typename ValueType>
 void DoublyLinkedList<ValueType>::deleteList(){
-	while(head->next != nullptr){
-		head = head->next;
-		delete head->prev;
+	while(head != nullptr){
+		Node* next = head->next;
+		deleteNode(head);
+		head = next;
 	}
-	delete head;
+	tail = nullptr;
+	qSize = 0;
 }
 
 template <typename ValueType>
 void DoublyLinkedList<ValueType>::copyList(const DoublyLinkedList& list){
 	if (list.head != nullptr){
 		try{
-	        head = new Node;
+	        head = newNode();
 	        head->value = list.head->value;
 	    }catch(...){
 	        throw;
@@ -657,7 +1034,7 @@ void DoublyLinkedList<ValueType>::copyList(const DoublyLinkedList& list){
 	    Node* curr2 = head;
 	    while(curr1 != nullptr){
 	        try{
-	            curr2->next = new Node;
+	            curr2->next = newNode();
 	            curr2->next->value = curr1->value;
 	            curr2->next->prev = curr2;
 
@@ -669,14 +1046,46 @@ void DoublyLinkedList<ValueType>::copyList(const DoublyLinkedList& list){
 	    }
 	    tail = curr2;
 	    qSize = list.qSize;
+	    counted(qSize);
 	}
 }
 
 template <typename ValueType>
 void DoublyLinkedList<ValueType>::removeNode(Node* rmv_node){
-	delete rmv_node;
+	if (rmv_node->prev != nullptr)
+		rmv_node->prev->next = rmv_node->next;
+	else
+		head = rmv_node->next;
+
+	if (rmv_node->next != nullptr)
+		rmv_node->next->prev = rmv_node->prev;
+	else
+		tail = rmv_node->prev;
+
+	deleteNode(rmv_node);
 	qSize--;
 }
 
+
+// Every node is allocated and freed through these, so that the memory
+// account sees all of them
+template <typename ValueType>
+typename DoublyLinkedList<ValueType>::Node* DoublyLinkedList<ValueType>::newNode()
+{
+	Node* node = new Node;
+	allocated(sizeof(Node));
+	return node;
+}
+
+
+template <typename ValueType>
+void DoublyLinkedList<ValueType>::deleteNode(Node* node) noexcept
+{
+	if (node != nullptr){
+		freed(sizeof(Node));
+		delete node;
+	}
+}
+
 #endif
 
@@ -0,0 +1,149 @@
+// DynamicBitset.hpp
+
+#ifndef DYNAMICBITSET_HPP
+#define DYNAMICBITSET_HPP
+
+#include <vector>
+
+
+
+// DynamicBitset is a fixed-size set of bits whose size is chosen at run
+// time.  Besides the usual per-bit operations, it exposes its contents one
+// 64-bit word at a time, so that callers can visit only the set bits by
+// repeatedly taking the lowest one (see lowestBit()).
+class DynamicBitset
+{
+public:
+    using Word = unsigned long long;
+    static constexpr unsigned int WordBits = 64;
+
+
+    // Initializes this bitset to hold size bits, all of them clear.
+    explicit DynamicBitset(unsigned int size = 0);
+
+
+    // set() sets the bit at the given index; reset() clears it; assign()
+    // sets it if value is true and clears it otherwise.
+    void set(unsigned int index) noexcept;
+    void reset(unsigned int index) noexcept;
+    void assign(unsigned int index, bool value) noexcept;
+
+
+    // test() returns true if the bit at the given index is set, false
+    // otherwise.
+    bool test(unsigned int index) const noexcept;
+
+
+    // count() returns the number of set bits.
+    unsigned int count() const noexcept;
+
+
+    // size() returns the number of bits in the bitset.
+    unsigned int size() const noexcept;
+
+
+    // wordCount() returns the number of words it takes to hold the bits;
+    // bit i lives in word i / WordBits.
+    unsigned int wordCount() const noexcept;
+
+
+    // word() returns the bits at indices [w * WordBits, (w + 1) * WordBits),
+    // the lowest index in the lowest bit.
+    Word word(unsigned int w) const noexcept;
+
+
+    // fullWord() returns what word(w) would be if every bit were set, i.e.
+    // a word with only the bits that are within size() set.
+    Word fullWord(unsigned int w) const noexcept;
+
+
+    // lowestBit() returns the position of the lowest set bit in a non-zero
+    // word.
+    static unsigned int lowestBit(Word word) noexcept;
+
+
+private:
+    std::vector<Word> words;
+    unsigned int bits;
+};
+
+
+
+inline DynamicBitset::DynamicBitset(unsigned int size)
+    : words((size + WordBits - 1) / WordBits, 0), bits{size}
+{
+}
+
+
+inline void DynamicBitset::set(unsigned int index) noexcept
+{
+    words[index / WordBits] |= Word{1} << (index % WordBits);
+}
+
+
+inline void DynamicBitset::reset(unsigned int index) noexcept
+{
+    words[index / WordBits] &= ~(Word{1} << (index % WordBits));
+}
+
+
+inline void DynamicBitset::assign(unsigned int index, bool value) noexcept
+{
+    if (value)
+        set(index);
+    else
+        reset(index);
+}
+
+
+inline bool DynamicBitset::test(unsigned int index) const noexcept
+{
+    return (words[index / WordBits] >> (index % WordBits)) & 1;
+}
+
+
+inline unsigned int DynamicBitset::count() const noexcept
+{
+    unsigned int total = 0;
+    for (Word word : words)
+        total += __builtin_popcountll(word);
+    return total;
+}
+
+
+inline unsigned int DynamicBitset::size() const noexcept
+{
+    return bits;
+}
+
+
+inline unsigned int DynamicBitset::wordCount() const noexcept
+{
+    return words.size();
+}
+
+
+inline DynamicBitset::Word DynamicBitset::word(unsigned int w) const noexcept
+{
+    return words[w];
+}
+
+
+inline DynamicBitset::Word DynamicBitset::fullWord(unsigned int w) const noexcept
+{
+    unsigned int remaining = bits - w * WordBits;
+    if (remaining >= WordBits)
+        return ~Word{0};
+    else
+        return (Word{1} << remaining) - 1;
+}
+
+
+inline unsigned int DynamicBitset::lowestBit(Word word) noexcept
+{
+    return __builtin_ctzll(word);
+}
+
+
+
+#endif
@@ -0,0 +1,72 @@
+// Fnv1aHash.hpp
+
+#ifndef FNV1AHASH_HPP
+#define FNV1AHASH_HPP
+
+#include <cstddef>
+
+
+
+// Fnv1aHash computes the 64-bit FNV-1a hash of a sequence of bytes that's
+// fed to it a piece at a time, so that data can be hashed while it's being
+// read rather than after.  It's quick and spreads its input well, but it's
+// not meant to stand up to anyone choosing inputs that collide.
+class Fnv1aHash
+{
+public:
+    using Value = unsigned long long;
+
+
+    // add() hashes the given bytes after everything that's been hashed
+    // so far.
+    void add(const void* bytes, std::size_t size) noexcept;
+
+
+    // addInt() hashes an integer as its 8 bytes, lowest first, so that the
+    // same numbers hash the same whatever type they were read as.
+    void addInt(long long value) noexcept;
+
+
+    // value() returns the hash of everything that's been hashed so far.
+    Value value() const noexcept;
+
+
+private:
+    static constexpr Value Offset = 14695981039346656037ull;
+    static constexpr Value Prime = 1099511628211ull;
+
+    Value hash = Offset;
+};
+
+
+
+inline void Fnv1aHash::add(const void* bytes, std::size_t size) noexcept
+{
+    const unsigned char* p = static_cast<const unsigned char*>(bytes);
+    for (std::size_t i = 0; i < size; i++){
+        hash ^= p[i];
+        hash *= Prime;
+    }
+}
+
+
+inline void Fnv1aHash::addInt(long long value) noexcept
+{
+    unsigned long long bits = value;
+    unsigned char bytes[8];
+    for (int i = 0; i < 8; i++){
+        bytes[i] = bits & 0xff;
+        bits >>= 8;
+    }
+    add(bytes, sizeof bytes);
+}
+
+
+inline Fnv1aHash::Value Fnv1aHash::value() const noexcept
+{
+    return hash;
+}
+
+
+
+#endif
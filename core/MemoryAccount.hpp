@@ -0,0 +1,209 @@
+// MemoryAccount.hpp
+
+#ifndef MEMORYACCOUNT_HPP
+#define MEMORYACCOUNT_HPP
+
+#include <cstddef>
+#ifdef STORESIM_MEMORY_ACCOUNTING
+#include <atomic>
+#endif
+
+
+
+// MemoryStats describes what a container (or every container together)
+// has allocated: the nodes and bytes it holds right now, the most bytes it
+// ever held at once, how many nodes it has allocated in all, and the most
+// values it ever held at once (which isn't kept for the total).
+struct MemoryStats
+{
+    unsigned long long liveNodes = 0;
+    unsigned long long liveBytes = 0;
+    unsigned long long peakBytes = 0;
+    unsigned long long allocations = 0;
+    unsigned long long peakValues = 0;
+};
+
+
+
+// MemoryAccount keeps count of what a container allocates.  Containers
+// derive from it (privately, exposing memory()) and tell it whenever they
+// allocate or free a node and whenever they grow; it keeps running totals
+// over all containers as well, which are safe to update from several
+// threads at once.
+//
+// The accounting is only compiled in when STORESIM_MEMORY_ACCOUNTING is
+// defined.  Otherwise the class is empty, which as a base class takes no
+// space, every member does nothing, and memory() and totalMemory() return
+// all zeros; Enabled says which it is.
+class MemoryAccount
+{
+public:
+#ifdef STORESIM_MEMORY_ACCOUNTING
+    static constexpr bool Enabled = true;
+#else
+    static constexpr bool Enabled = false;
+#endif
+
+
+    // allocated() and freed() record that a node of the given size was
+    // allocated or freed.
+    void allocated(std::size_t bytes) noexcept;
+    void freed(std::size_t bytes) noexcept;
+
+
+    // counted() records that the container now holds the given number of
+    // values.
+    void counted(unsigned long long values) noexcept;
+
+
+    // swapAccount() swaps this account with another, for containers that
+    // swap their contents.
+    void swapAccount(MemoryAccount& account) noexcept;
+
+
+    // memory() returns what this container has allocated.
+    MemoryStats memory() const noexcept;
+
+
+    // totalMemory() returns what every container has allocated together.
+    static MemoryStats totalMemory() noexcept;
+
+
+protected:
+    // A container's account starts empty even when the container is a copy
+    // of another; copying the account itself would count the other
+    // container's nodes twice.
+    MemoryAccount() noexcept = default;
+    MemoryAccount(const MemoryAccount&) noexcept;
+    MemoryAccount& operator=(const MemoryAccount&) noexcept;
+    ~MemoryAccount() noexcept = default;
+
+
+#ifdef STORESIM_MEMORY_ACCOUNTING
+private:
+    MemoryStats stats;
+
+    static std::atomic<unsigned long long> totalLiveNodes;
+    static std::atomic<unsigned long long> totalLiveBytes;
+    static std::atomic<unsigned long long> totalPeakBytes;
+    static std::atomic<unsigned long long> totalAllocations;
+#endif
+};
+
+
+
+inline MemoryAccount::MemoryAccount(const MemoryAccount&) noexcept
+{
+}
+
+
+inline MemoryAccount& MemoryAccount::operator=(const MemoryAccount&) noexcept
+{
+    return *this;
+}
+
+
+#ifdef STORESIM_MEMORY_ACCOUNTING
+
+inline std::atomic<unsigned long long> MemoryAccount::totalLiveNodes{0};
+inline std::atomic<unsigned long long> MemoryAccount::totalLiveBytes{0};
+inline std::atomic<unsigned long long> MemoryAccount::totalPeakBytes{0};
+inline std::atomic<unsigned long long> MemoryAccount::totalAllocations{0};
+
+
+inline void MemoryAccount::allocated(std::size_t bytes) noexcept
+{
+    stats.liveNodes++;
+    stats.liveBytes += bytes;
+    stats.allocations++;
+    if (stats.liveBytes > stats.peakBytes)
+        stats.peakBytes = stats.liveBytes;
+
+    totalLiveNodes.fetch_add(1, std::memory_order_relaxed);
+    totalAllocations.fetch_add(1, std::memory_order_relaxed);
+    unsigned long long live = totalLiveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    unsigned long long peak = totalPeakBytes.load(std::memory_order_relaxed);
+    while (live > peak && !totalPeakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)){
+    }
+}
+
+
+inline void MemoryAccount::freed(std::size_t bytes) noexcept
+{
+    stats.liveNodes--;
+    stats.liveBytes -= bytes;
+
+    totalLiveNodes.fetch_sub(1, std::memory_order_relaxed);
+    totalLiveBytes.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+
+inline void MemoryAccount::counted(unsigned long long values) noexcept
+{
+    if (values > stats.peakValues)
+        stats.peakValues = values;
+}
+
+
+inline void MemoryAccount::swapAccount(MemoryAccount& account) noexcept
+{
+    MemoryStats temp = stats;
+    stats = account.stats;
+    account.stats = temp;
+}
+
+
+inline MemoryStats MemoryAccount::memory() const noexcept
+{
+    return stats;
+}
+
+
+inline MemoryStats MemoryAccount::totalMemory() noexcept
+{
+    MemoryStats total;
+    total.liveNodes = totalLiveNodes.load(std::memory_order_relaxed);
+    total.liveBytes = totalLiveBytes.load(std::memory_order_relaxed);
+    total.peakBytes = totalPeakBytes.load(std::memory_order_relaxed);
+    total.allocations = totalAllocations.load(std::memory_order_relaxed);
+    return total;
+}
+
+#else
+
+inline void MemoryAccount::allocated(std::size_t) noexcept
+{
+}
+
+
+inline void MemoryAccount::freed(std::size_t) noexcept
+{
+}
+
+
+inline void MemoryAccount::counted(unsigned long long) noexcept
+{
+}
+
+
+inline void MemoryAccount::swapAccount(MemoryAccount&) noexcept
+{
+}
+
+
+inline MemoryStats MemoryAccount::memory() const noexcept
+{
+    return MemoryStats{};
+}
+
+
+inline MemoryStats MemoryAccount::totalMemory() noexcept
+{
+    return MemoryStats{};
+}
+
+#endif
+
+
+
+#endif
@@ -0,0 +1,119 @@
+// MinMaxTree.hpp
+
+#ifndef MINMAXTREE_HPP
+#define MINMAXTREE_HPP
+
+#include <vector>
+
+
+
+// MinMaxTree is a fixed-size array of integers that always knows where its
+// smallest and its largest value are.  It's a tournament tree: every
+// internal node keeps the indices of the smallest and the largest value
+// below it, so changing a value only replays the O(log size) matches on
+// its way up to the root, and finding either one is O(1).  Ties go to the
+// lowest index, the same as a scan from the front would pick.
+class MinMaxTree
+{
+public:
+    // Initializes this tree to hold size values, all of them 0.
+    explicit MinMaxTree(unsigned int size = 0);
+
+
+    // set() changes the value at the given index; get() returns it.
+    void set(unsigned int index, int value) noexcept;
+    int get(unsigned int index) const noexcept;
+
+
+    // minIndex() and maxIndex() return the index of the smallest and the
+    // largest value, the lowest such index if there are several.  They
+    // return 0 if the tree is empty.
+    unsigned int minIndex() const noexcept;
+    unsigned int maxIndex() const noexcept;
+
+
+    // size() returns the number of values in the tree.
+    unsigned int size() const noexcept;
+
+
+private:
+    // The leaf for the value at index i is node size() + i, and node k's
+    // children are nodes 2k and 2k + 1, with the root at node 1.  minAt
+    // and maxAt hold, for each node, the index of the value that won it.
+    std::vector<int> values;
+    std::vector<unsigned int> minAt;
+    std::vector<unsigned int> maxAt;
+
+    bool less(unsigned int a, unsigned int b) const noexcept;
+    bool greater(unsigned int a, unsigned int b) const noexcept;
+    void replay(unsigned int node) noexcept;
+};
+
+
+
+inline MinMaxTree::MinMaxTree(unsigned int size)
+    : values(size, 0), minAt(size > 0 ? 2 * size : 2, 0), maxAt(size > 0 ? 2 * size : 2, 0)
+{
+    for (unsigned int i = 0; i < size; i++){
+        minAt[size + i] = i;
+        maxAt[size + i] = i;
+    }
+    for (unsigned int node = size; node-- > 1; )
+        replay(node);
+}
+
+
+inline void MinMaxTree::set(unsigned int index, int value) noexcept
+{
+    values[index] = value;
+    for (unsigned int node = (values.size() + index) / 2; node >= 1; node /= 2)
+        replay(node);
+}
+
+
+inline int MinMaxTree::get(unsigned int index) const noexcept
+{
+    return values[index];
+}
+
+
+inline unsigned int MinMaxTree::minIndex() const noexcept
+{
+    return minAt[1];
+}
+
+
+inline unsigned int MinMaxTree::maxIndex() const noexcept
+{
+    return maxAt[1];
+}
+
+
+inline unsigned int MinMaxTree::size() const noexcept
+{
+    return values.size();
+}
+
+
+inline bool MinMaxTree::less(unsigned int a, unsigned int b) const noexcept
+{
+    return values[a] < values[b] || (values[a] == values[b] && a < b);
+}
+
+
+inline bool MinMaxTree::greater(unsigned int a, unsigned int b) const noexcept
+{
+    return values[a] > values[b] || (values[a] == values[b] && a < b);
+}
+
+
+inline void MinMaxTree::replay(unsigned int node) noexcept
+{
+    unsigned int left = 2 * node, right = 2 * node + 1;
+    minAt[node] = less(minAt[left], minAt[right]) ? minAt[left] : minAt[right];
+    maxAt[node] = greater(maxAt[left], maxAt[right]) ? maxAt[left] : maxAt[right];
+}
+
+
+
+#endif
@@ -7,8 +7,11 @@
 
 
 
-template <typename ValueType>
-class Queue : private DoublyLinkedList<ValueType>
+// A Queue is built on top of a list, a DoublyLinkedList by default; any
+// list with the same member functions, like UnrolledLinkedList, can be
+// used instead.
+template <typename ValueType, typename List = DoublyLinkedList<ValueType>>
+class Queue : private List
 {
 public:
     void enqueue(const ValueType& value);
@@ -16,37 +19,104 @@ public:
     void dequeue();
     
     const ValueType& front() const;
-    
-    using DoublyLinkedList<ValueType>::isEmpty;
-    using DoublyLinkedList<ValueType>::size;
 
-    using DoublyLinkedList<ValueType>::constIterator;
-    using ConstIterator = typename DoublyLinkedList<ValueType>::ConstIterator;
+    // tryDequeue() and tryFront() never throw: tryDequeue() returns false
+    // rather than throwing when the queue is empty, and tryFront() returns
+    // a pointer to the front value, or nullptr.  They're meant for callers
+    // that check for an empty queue anyway, which can check with them.
+    bool tryDequeue() noexcept;
+
+    const ValueType* tryFront() const noexcept;
+
+    // tryBack() and tryDequeueBack() are the same, but for the value at
+    // the back of the queue, for callers that also take values off the
+    // back (like a customer leaving the end of a line).
+    const ValueType* tryBack() const noexcept;
+
+    bool tryDequeueBack() noexcept;
+    
+    using List::isEmpty;
+    using List::size;
+    using List::memory;
+
+    using List::constIterator;
+    using ConstIterator = typename List::ConstIterator;
+
+    // A queue can only be iterated over read-only, from front to back,
+    // with standard bidirectional iterators (see DoublyLinkedList::begin()).
+    using value_type = ValueType;
+    using const_iterator = typename List::ConstStlIterator;
+
+    const_iterator begin() const noexcept;
+    const_iterator end() const noexcept;
+    using List::cbegin;
+    using List::cend;
 };
 
 
 
-template <typename ValueType>
-void Queue<ValueType>::enqueue(const ValueType& value)
+template <typename ValueType, typename List>
+void Queue<ValueType, List>::enqueue(const ValueType& value)
 {
     this->addToEnd(value);
 }
 
 
-template <typename ValueType>
-void Queue<ValueType>::dequeue()
+template <typename ValueType, typename List>
+void Queue<ValueType, List>::dequeue()
 {
     this->removeFromStart();
 }
 
 
-template <typename ValueType>
-const ValueType& Queue<ValueType>::front() const
+template <typename ValueType, typename List>
+const ValueType& Queue<ValueType, List>::front() const
 {
     return this->first();
 }
 
 
+template <typename ValueType, typename List>
+bool Queue<ValueType, List>::tryDequeue() noexcept
+{
+    return this->tryRemoveFromStart();
+}
 
-#endif
 
+template <typename ValueType, typename List>
+const ValueType* Queue<ValueType, List>::tryFront() const noexcept
+{
+    return this->tryFirst();
+}
+
+
+template <typename ValueType, typename List>
+const ValueType* Queue<ValueType, List>::tryBack() const noexcept
+{
+    return this->tryLast();
+}
+
+
+template <typename ValueType, typename List>
+bool Queue<ValueType, List>::tryDequeueBack() noexcept
+{
+    return this->tryRemoveFromEnd();
+}
+
+
+template <typename ValueType, typename List>
+typename Queue<ValueType, List>::const_iterator Queue<ValueType, List>::begin() const noexcept
+{
+    return this->cbegin();
+}
+
+
+template <typename ValueType, typename List>
+typename Queue<ValueType, List>::const_iterator Queue<ValueType, List>::end() const noexcept
+{
+    return this->cend();
+}
+
+
+
+#endif
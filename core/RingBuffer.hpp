@@ -0,0 +1,111 @@
+// RingBuffer.hpp
+
+#ifndef RINGBUFFER_HPP
+#define RINGBUFFER_HPP
+
+#include <cstddef>
+#include <vector>
+
+
+
+// RingBuffer keeps the most recent values pushed onto it, up to a capacity
+// that's fixed (and allocated) up front.  Once it's full, every push
+// overwrites the oldest value, so recording into it never allocates and
+// never fails; dropped() says how many values were lost that way.
+template <typename ValueType>
+class RingBuffer
+{
+public:
+    // Initializes this buffer to hold up to capacity values (at least 1).
+    explicit RingBuffer(std::size_t capacity);
+
+
+    // push() adds a value as the newest one, overwriting the oldest one if
+    // the buffer is full.
+    void push(const ValueType& value);
+
+
+    // operator[] returns the value at the given index, 0 being the oldest
+    // value and size() - 1 the newest.  The index isn't checked.
+    const ValueType& operator[](std::size_t index) const noexcept;
+
+
+    // size() returns the number of values in the buffer.
+    std::size_t size() const noexcept;
+
+
+    // capacity() returns the most values the buffer can hold.
+    std::size_t capacity() const noexcept;
+
+
+    // dropped() returns the number of values that were overwritten.
+    unsigned long long dropped() const noexcept;
+
+
+private:
+    std::vector<ValueType> values;
+    std::size_t oldest = 0;
+    std::size_t count = 0;
+    unsigned long long droppedCount = 0;
+};
+
+
+
+template <typename ValueType>
+RingBuffer<ValueType>::RingBuffer(std::size_t capacity)
+    : values(capacity > 0 ? capacity : 1)
+{
+}
+
+
+template <typename ValueType>
+void RingBuffer<ValueType>::push(const ValueType& value)
+{
+    std::size_t next = oldest + count;
+    if (next >= values.size())
+        next -= values.size();
+    values[next] = value;
+
+    if (count < values.size()){
+        count++;
+    }
+    else{
+        oldest = oldest + 1 == values.size() ? 0 : oldest + 1;
+        droppedCount++;
+    }
+}
+
+
+template <typename ValueType>
+const ValueType& RingBuffer<ValueType>::operator[](std::size_t index) const noexcept
+{
+    std::size_t i = oldest + index;
+    if (i >= values.size())
+        i -= values.size();
+    return values[i];
+}
+
+
+template <typename ValueType>
+std::size_t RingBuffer<ValueType>::size() const noexcept
+{
+    return count;
+}
+
+
+template <typename ValueType>
+std::size_t RingBuffer<ValueType>::capacity() const noexcept
+{
+    return values.size();
+}
+
+
+template <typename ValueType>
+unsigned long long RingBuffer<ValueType>::dropped() const noexcept
+{
+    return droppedCount;
+}
+
+
+
+#endif
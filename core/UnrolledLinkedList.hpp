@@ -0,0 +1,1192 @@
+// UnrolledLinkedList.hpp
+
+#ifndef UNROLLEDLINKEDLIST_HPP
+#define UNROLLEDLINKEDLIST_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include "EmptyException.hpp"
+#include "IteratorException.hpp"
+#include "MemoryAccount.hpp"
+
+
+
+// UnrolledLinkedList is a drop-in alternative to DoublyLinkedList that
+// stores several values per node instead of one.  Each node is NodeBytes
+// (by default, one cache line) in size, so walking the list or churning
+// values at either end touches one cache line per handful of values
+// rather than one per value.  It has the same member functions, and its
+// Iterator and ConstIterator behave the same way as DoublyLinkedList's,
+// including insertBefore(), insertAfter() and remove() in the middle of
+// the list.
+template <typename ValueType, unsigned int NodeBytes = 64>
+class UnrolledLinkedList : private MemoryAccount
+{
+public:
+    class Iterator;
+    class ConstIterator;
+    class StlIterator;
+    class ConstStlIterator;
+
+    using value_type = ValueType;
+    using size_type = unsigned int;
+    using difference_type = std::ptrdiff_t;
+    using reference = ValueType&;
+    using const_reference = const ValueType&;
+    using const_iterator = ConstStlIterator;
+
+private:
+    struct Node;
+
+
+public:
+    // Initializes this list to be empty.
+    UnrolledLinkedList() noexcept;
+
+    // Initializes this list as a copy of an existing one.
+    UnrolledLinkedList(const UnrolledLinkedList& list);
+
+    // Initializes this list from an expiring one.
+    UnrolledLinkedList(UnrolledLinkedList&& list) noexcept;
+
+
+    // Destroys the contents of this list.
+    virtual ~UnrolledLinkedList() noexcept;
+
+
+    // Replaces the contents of this list with a copy of the contents
+    // of an existing one.
+    UnrolledLinkedList& operator=(const UnrolledLinkedList& list);
+
+    // Replaces the contents of this list with the contents of an
+    // expiring one.
+    UnrolledLinkedList& operator=(UnrolledLinkedList&& list) noexcept;
+
+
+    // addToStart() adds a value to the start of the list, meaning that
+    // it will now be the first value, with all subsequent elements still
+    // being in the list (after the new value) in the same order.
+    void addToStart(const ValueType& value);
+
+    // addToEnd() adds a value to the end of the list, meaning that
+    // it will now be the last value, with all subsequent elements still
+    // being in the list (before the new value) in the same order.
+    void addToEnd(const ValueType& value);
+
+
+    // removeFromStart() removes a value from the start of the list, meaning
+    // that the list will now contain all of the values *in the same order*
+    // that it did before, *except* that the first one will be gone.
+    // In the event that the list is empty, an EmptyException will be thrown.
+    void removeFromStart();
+
+    // removeFromEnd() removes a value from the end of the list, meaning
+    // that the list will now contain all of the values *in the same order*
+    // that it did before, *except* that the last one will be gone.
+    // In the event that the list is empty, an EmptyException will be thrown.
+    void removeFromEnd();
+
+
+    // tryRemoveFromStart() and tryRemoveFromEnd() do the same as
+    // removeFromStart() and removeFromEnd(), except that they never throw:
+    // they return true if they removed a value and false if the list was
+    // empty.
+    bool tryRemoveFromStart() noexcept;
+    bool tryRemoveFromEnd() noexcept;
+
+
+    // first() returns the value at the start of the list.  In the event that
+    // the list is empty, an EmptyException will be thrown.  There are two
+    // variants of this member function: one for a const UnrolledLinkedList
+    // and another for a non-const one.
+    const ValueType& first() const;
+    ValueType& first();
+
+
+    // last() returns the value at the end of the list.  In the event that
+    // the list is empty, an EmptyException will be thrown.  There are two
+    // variants of this member function: one for a const UnrolledLinkedList
+    // and another for a non-const one.
+    const ValueType& last() const;
+    ValueType& last();
+
+
+    // tryFirst() and tryLast() return a pointer to the value that first()
+    // and last() would return, or nullptr (rather than throwing) if the list
+    // is empty.
+    const ValueType* tryFirst() const noexcept;
+    ValueType* tryFirst() noexcept;
+    const ValueType* tryLast() const noexcept;
+    ValueType* tryLast() noexcept;
+
+
+    // isEmpty() returns true if the list has no values in it, false
+    // otherwise.
+    bool isEmpty() const noexcept;
+
+
+    // size() returns the number of values in the list.
+    unsigned int size() const noexcept;
+
+
+    // memory() returns what the list has allocated, if memory accounting
+    // is compiled in (see MemoryAccount.hpp).
+    using MemoryAccount::memory;
+
+    Iterator iterator();
+
+    ConstIterator constIterator() const;
+
+
+    // begin() and end() return unchecked standard bidirectional iterators,
+    // as in DoublyLinkedList.  Any insertion or removal invalidates them.
+    StlIterator begin() noexcept;
+    StlIterator end() noexcept;
+    ConstStlIterator begin() const noexcept;
+    ConstStlIterator end() const noexcept;
+    ConstStlIterator cbegin() const noexcept;
+    ConstStlIterator cend() const noexcept;
+
+
+public:
+    class IteratorBase
+    {
+    public:
+        // Initializes a newly-constructed IteratorBase to operate on
+        // the given list.  It will initially be referring to the first
+        // value in the list, unless the list is empty, in which case
+        // it will be considered to be both "past start" and "past end".
+        IteratorBase(const UnrolledLinkedList& list) noexcept;
+
+
+        // moveToNext() moves this iterator forward to the next value in
+        // the list.  If the iterator is refrering to the last value, it
+        // moves to the "past end" position.  If it is already at the
+        // "past end" position, an IteratorException will be thrown.
+        void moveToNext();
+
+
+        // moveToPrevious() moves this iterator backward to the previous
+        // value in the list.  If the iterator is refrering to the first
+        // value, it moves to the "past start" position.  If it is already
+        // at the "past start" position, an IteratorException will be thrown.
+        void moveToPrevious();
+
+
+        // isPastStart() returns true if this iterator is in the "past
+        // start" position, false otherwise.
+        bool isPastStart() const noexcept;
+
+
+        // isPastEnd() returns true if this iterator is in the "past end"
+        // position, false otherwise.
+        bool isPastEnd() const noexcept;
+
+    protected:
+        // The iterator refers to the value at index within current; in
+        // the "past start" and "past end" positions it stays on the first
+        // and last value respectively.
+        Node* current;
+        unsigned int index = 0;
+        bool pastStart = false;
+        bool pastEnd = false;
+        UnrolledLinkedList* plist;
+    };
+
+
+    class ConstIterator : public IteratorBase
+    {
+    public:
+        // Initializes a newly-constructed ConstIterator to operate on
+        // the given list.  It will initially be referring to the first
+        // value in the list, unless the list is empty, in which case
+        // it will be considered to be both "past start" and "past end".
+        ConstIterator(const UnrolledLinkedList& list) noexcept;
+
+
+        // value() returns the value that the iterator is currently
+        // referring to.  If the iterator is in the "past start" or
+        // "past end" positions, an IteratorException will be thrown.
+        const ValueType& value() const;
+    };
+
+
+    class Iterator : public IteratorBase
+    {
+    public:
+        // Initializes a newly-constructed Iterator to operate on the
+        // given list.  It will initially be referring to the first
+        // value in the list, unless the list is empty, in which case
+        // it will be considered to be both "past start" and "past end".
+        Iterator(UnrolledLinkedList& list) noexcept;
+
+
+        // value() returns the value that the iterator is currently
+        // referring to.  If the iterator is in the "past start" or
+        // "past end" positions, an IteratorException will be thrown.
+        ValueType& value() const;
+
+
+        // insertBefore() inserts a new value into the list before
+        // the one to which the iterator currently refers.  If the
+        // iterator is in the "past start" position, an IteratorException
+        // is thrown.
+        void insertBefore(const ValueType& value);
+
+
+        // insertAfter() inserts a new value into the list after
+        // the one to which the iterator currently refers.  If the
+        // iterator is in the "past end" position, an IteratorException
+        // is thrown.
+        void insertAfter(const ValueType& value);
+
+
+        // remove() removes the value to which this iterator refers,
+        // moving the iterator to refer to either the value after it
+        // (if moveToNextAfterward is true) or before it (if
+        // moveToNextAfterward is false).  If the iterator is in the
+        // "past start" or "past end" position, an IteratorException
+        // is thrown.
+        void remove(bool moveToNextAfterward = true);
+    };
+
+
+    class StlIterator
+    {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = ValueType;
+        using difference_type = std::ptrdiff_t;
+        using pointer = ValueType*;
+        using reference = ValueType&;
+
+        StlIterator() noexcept = default;
+
+        ValueType& operator*() const noexcept;
+        ValueType* operator->() const noexcept;
+
+        StlIterator& operator++() noexcept;
+        StlIterator operator++(int) noexcept;
+        StlIterator& operator--() noexcept;
+        StlIterator operator--(int) noexcept;
+
+        bool operator==(const StlIterator& other) const noexcept;
+        bool operator!=(const StlIterator& other) const noexcept;
+
+    private:
+        friend class UnrolledLinkedList;
+        friend class ConstStlIterator;
+
+        StlIterator(Node* node, unsigned int index, const UnrolledLinkedList* list) noexcept;
+
+        // The end() position is a nullptr node.
+        Node* node = nullptr;
+        unsigned int index = 0;
+        const UnrolledLinkedList* list = nullptr;
+    };
+
+
+    class ConstStlIterator
+    {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = ValueType;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const ValueType*;
+        using reference = const ValueType&;
+
+        ConstStlIterator() noexcept = default;
+
+        // Initializes a newly-constructed ConstStlIterator to refer to
+        // the same position as a non-const one.
+        ConstStlIterator(const StlIterator& iterator) noexcept;
+
+        const ValueType& operator*() const noexcept;
+        const ValueType* operator->() const noexcept;
+
+        ConstStlIterator& operator++() noexcept;
+        ConstStlIterator operator++(int) noexcept;
+        ConstStlIterator& operator--() noexcept;
+        ConstStlIterator operator--(int) noexcept;
+
+        bool operator==(const ConstStlIterator& other) const noexcept;
+        bool operator!=(const ConstStlIterator& other) const noexcept;
+
+    private:
+        friend class UnrolledLinkedList;
+
+        ConstStlIterator(const Node* node, unsigned int index, const UnrolledLinkedList* list) noexcept;
+
+        const Node* node = nullptr;
+        unsigned int index = 0;
+        const UnrolledLinkedList* list = nullptr;
+    };
+
+
+private:
+    // As many values as fit in a node alongside its header (padded for the
+    // values' alignment), but at least one, however large a value is.
+    static constexpr unsigned int HeaderBytes =
+        (2 * sizeof(void*) + 2 * sizeof(unsigned short) + alignof(ValueType) - 1)
+        / alignof(ValueType) * alignof(ValueType);
+    static constexpr unsigned int Capacity =
+        NodeBytes > HeaderBytes + sizeof(ValueType) ? (NodeBytes - HeaderBytes) / sizeof(ValueType) : 1;
+
+
+    // A node holds count values in values[start] through
+    // values[start + count - 1], so that values can be added to or
+    // removed from either end of a node without shifting the others.
+    // Nodes are never left empty.  Each node is aligned to NodeBytes, so
+    // that it starts (and ends) on a cache line boundary rather than
+    // straddling two.
+    struct alignas(NodeBytes) Node
+    {
+        Node* prev = nullptr;
+        Node* next = nullptr;
+        unsigned short start = 0;
+        unsigned short count = 0;
+        ValueType values[Capacity];
+
+        ValueType& at(unsigned int i) noexcept { return values[start + i]; }
+        const ValueType& at(unsigned int i) const noexcept { return values[start + i]; }
+    };
+
+    static_assert(Capacity == 1 || sizeof(Node) == NodeBytes,
+                  "a node that holds more than one value must be exactly NodeBytes");
+
+
+    // A position of a value: the node it's in and its index within it.
+    // A nullptr node is the position after the last value.
+    struct Position
+    {
+        Node* node;
+        unsigned int index;
+    };
+
+
+    Node* head = nullptr;
+    Node* tail = nullptr;
+    unsigned int listSize = 0;
+
+    Node* linkNewNode(Node* prev, Node* next, unsigned short start);
+    void unlinkNode(Node* node) noexcept;
+    Position insertAt(Position position, const ValueType& value);
+    Position removeAt(Position position) noexcept;
+    void mergeNext(Node* node) noexcept;
+    Position nextPosition(Position position) const noexcept;
+    Position previousPosition(Position position) const noexcept;
+    void deleteList() noexcept;
+    void copyList(const UnrolledLinkedList& list);
+    void swap(UnrolledLinkedList& list) noexcept;
+};
+
+
+
+template <typename ValueType, unsigned int NodeBytes>
+UnrolledLinkedList<ValueType, NodeBytes>::UnrolledLinkedList() noexcept
+{
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+UnrolledLinkedList<ValueType, NodeBytes>::UnrolledLinkedList(const UnrolledLinkedList& list)
+{
+    copyList(list);
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+UnrolledLinkedList<ValueType, NodeBytes>::UnrolledLinkedList(UnrolledLinkedList&& list) noexcept
+{
+    swap(list);
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+UnrolledLinkedList<ValueType, NodeBytes>::~UnrolledLinkedList() noexcept
+{
+    deleteList();
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+UnrolledLinkedList<ValueType, NodeBytes>& UnrolledLinkedList<ValueType, NodeBytes>::operator=(const UnrolledLinkedList& list)
+{
+    if (this != &list){
+        UnrolledLinkedList copy{list};
+        swap(copy);
+    }
+    return *this;
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+UnrolledLinkedList<ValueType, NodeBytes>& UnrolledLinkedList<ValueType, NodeBytes>::operator=(UnrolledLinkedList&& list) noexcept
+{
+    swap(list);
+    return *this;
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+void UnrolledLinkedList<ValueType, NodeBytes>::addToStart(const ValueType& value)
+{
+    if (head == nullptr){
+        Node* node = linkNewNode(nullptr, nullptr, Capacity - 1);
+        node->at(0) = value;
+        node->count = 1;
+        listSize++;
+        counted(listSize);
+    }
+    else{
+        insertAt(Position{head, 0}, value);
+    }
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+void UnrolledLinkedList<ValueType, NodeBytes>::addToEnd(const ValueType& value)
+{
+    if (tail == nullptr){
+        Node* node = linkNewNode(nullptr, nullptr, 0);
+        node->at(0) = value;
+        node->count = 1;
+        listSize++;
+        counted(listSize);
+    }
+    else{
+        insertAt(Position{tail, tail->count}, value);
+    }
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+void UnrolledLinkedList<ValueType, NodeBytes>::removeFromStart()
+{
+    if (!tryRemoveFromStart())
+        throw EmptyException();
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+void UnrolledLinkedList<ValueType, NodeBytes>::removeFromEnd()
+{
+    if (!tryRemoveFromEnd())
+        throw EmptyException();
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+bool UnrolledLinkedList<ValueType, NodeBytes>::tryRemoveFromStart() noexcept
+{
+    if (head == nullptr)
+        return false;
+    removeAt(Position{head, 0});
+    return true;
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+bool UnrolledLinkedList<ValueType, NodeBytes>::tryRemoveFromEnd() noexcept
+{
+    if (tail == nullptr)
+        return false;
+    removeAt(Position{tail, tail->count - 1u});
+    return true;
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+const ValueType& UnrolledLinkedList<ValueType, NodeBytes>::first() const
+{
+    if (head == nullptr)
+        throw EmptyException();
+    else
+        return head->at(0);
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+ValueType& UnrolledLinkedList<ValueType, NodeBytes>::first()
+{
+    if (head == nullptr)
+        throw EmptyException();
+    else
+        return head->at(0);
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+const ValueType& UnrolledLinkedList<ValueType, NodeBytes>::last() const
+{
+    if (tail == nullptr)
+        throw EmptyException();
+    else
+        return tail->at(tail->count - 1);
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+ValueType& UnrolledLinkedList<ValueType, NodeBytes>::last()
+{
+    if (tail == nullptr)
+        throw EmptyException();
+    else
+        return tail->at(tail->count - 1);
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+const ValueType* UnrolledLinkedList<ValueType, NodeBytes>::tryFirst() const noexcept
+{
+    return head != nullptr ? &head->at(0) : nullptr;
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+ValueType* UnrolledLinkedList<ValueType, NodeBytes>::tryFirst() noexcept
+{
+    return head != nullptr ? &head->at(0) : nullptr;
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+const ValueType* UnrolledLinkedList<ValueType, NodeBytes>::tryLast() const noexcept
+{
+    return tail != nullptr ? &tail->at(tail->count - 1) : nullptr;
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+ValueType* UnrolledLinkedList<ValueType, NodeBytes>::tryLast() noexcept
+{
+    return tail != nullptr ? &tail->at(tail->count - 1) : nullptr;
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+unsigned int UnrolledLinkedList<ValueType, NodeBytes>::size() const noexcept
+{
+    return listSize;
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+bool UnrolledLinkedList<ValueType, NodeBytes>::isEmpty() const noexcept
+{
+    return listSize == 0;
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+typename UnrolledLinkedList<ValueType, NodeBytes>::Iterator UnrolledLinkedList<ValueType, NodeBytes>::iterator()
+{
+    return Iterator{*this};
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+typename UnrolledLinkedList<ValueType, NodeBytes>::ConstIterator UnrolledLinkedList<ValueType, NodeBytes>::constIterator() const
+{
+    return ConstIterator{*this};
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+typename UnrolledLinkedList<ValueType, NodeBytes>::StlIterator UnrolledLinkedList<ValueType, NodeBytes>::begin() noexcept
+{
+    return StlIterator{head, 0, this};
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+typename UnrolledLinkedList<ValueType, NodeBytes>::StlIterator UnrolledLinkedList<ValueType, NodeBytes>::end() noexcept
+{
+    return StlIterator{nullptr, 0, this};
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+typename UnrolledLinkedList<ValueType, NodeBytes>::ConstStlIterator UnrolledLinkedList<ValueType, NodeBytes>::begin() const noexcept
+{
+    return ConstStlIterator{head, 0, this};
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+typename UnrolledLinkedList<ValueType, NodeBytes>::ConstStlIterator UnrolledLinkedList<ValueType, NodeBytes>::end() const noexcept
+{
+    return ConstStlIterator{nullptr, 0, this};
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+typename UnrolledLinkedList<ValueType, NodeBytes>::ConstStlIterator UnrolledLinkedList<ValueType, NodeBytes>::cbegin() const noexcept
+{
+    return begin();
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+typename UnrolledLinkedList<ValueType, NodeBytes>::ConstStlIterator UnrolledLinkedList<ValueType, NodeBytes>::cend() const noexcept
+{
+    return end();
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+UnrolledLinkedList<ValueType, NodeBytes>::IteratorBase::IteratorBase(const UnrolledLinkedList& list) noexcept
+    : current{list.head}, pastStart{list.head == nullptr}, pastEnd{list.head == nullptr},
+      plist{const_cast<UnrolledLinkedList*>(&list)}
+{
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+void UnrolledLinkedList<ValueType, NodeBytes>::IteratorBase::moveToNext()
+{
+    if (pastEnd)
+        throw IteratorException();
+    else if (pastStart)
+        pastStart = false;
+    else if (index + 1 < current->count)
+        index++;
+    else if (current->next != nullptr){
+        current = current->next;
+        index = 0;
+    }
+    else
+        pastEnd = true;
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+void UnrolledLinkedList<ValueType, NodeBytes>::IteratorBase::moveToPrevious()
+{
+    if (pastStart)
+        throw IteratorException();
+    else if (pastEnd)
+        pastEnd = false;
+    else if (index > 0)
+        index--;
+    else if (current->prev != nullptr){
+        current = current->prev;
+        index = current->count - 1;
+    }
+    else
+        pastStart = true;
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+bool UnrolledLinkedList<ValueType, NodeBytes>::IteratorBase::isPastStart() const noexcept
+{
+    return pastStart;
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+bool UnrolledLinkedList<ValueType, NodeBytes>::IteratorBase::isPastEnd() const noexcept
+{
+    return pastEnd;
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+UnrolledLinkedList<ValueType, NodeBytes>::ConstIterator::ConstIterator(const UnrolledLinkedList& list) noexcept
+    : IteratorBase{list}
+{
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+const ValueType& UnrolledLinkedList<ValueType, NodeBytes>::ConstIterator::value() const
+{
+    if (this->isPastEnd() || this->isPastStart())
+        throw IteratorException();
+    return this->current->at(this->index);
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+UnrolledLinkedList<ValueType, NodeBytes>::Iterator::Iterator(UnrolledLinkedList& list) noexcept
+    : IteratorBase{list}
+{
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+ValueType& UnrolledLinkedList<ValueType, NodeBytes>::Iterator::value() const
+{
+    if (this->isPastEnd() || this->isPastStart())
+        throw IteratorException();
+    return this->current->at(this->index);
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+void UnrolledLinkedList<ValueType, NodeBytes>::Iterator::insertBefore(const ValueType& value)
+{
+    if (this->isPastStart())
+        throw IteratorException();
+
+    if (this->isPastEnd()){
+        this->plist->addToEnd(value);
+        this->current = this->plist->tail;
+        this->index = this->current->count - 1;
+    }
+    else{
+        Position inserted = this->plist->insertAt(Position{this->current, this->index}, value);
+        Position position = this->plist->nextPosition(inserted);
+        this->current = position.node;
+        this->index = position.index;
+    }
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+void UnrolledLinkedList<ValueType, NodeBytes>::Iterator::insertAfter(const ValueType& value)
+{
+    if (this->isPastEnd())
+        throw IteratorException();
+
+    if (this->isPastStart()){
+        this->plist->addToStart(value);
+        this->current = this->plist->head;
+        this->index = 0;
+    }
+    else{
+        Position inserted = this->plist->insertAt(Position{this->current, this->index + 1}, value);
+        Position position = this->plist->previousPosition(inserted);
+        this->current = position.node;
+        this->index = position.index;
+    }
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+void UnrolledLinkedList<ValueType, NodeBytes>::Iterator::remove(bool moveToNextAfterward)
+{
+    if (this->isPastStart() || this->isPastEnd())
+        throw IteratorException();
+
+    bool hadPrevious = this->index > 0 || this->current->prev != nullptr;
+    Position position = this->plist->removeAt(Position{this->current, this->index});
+
+    if (this->plist->head == nullptr){
+        position = Position{nullptr, 0};
+        this->pastStart = true;
+        this->pastEnd = true;
+    }
+    else if (moveToNextAfterward){
+        if (position.node == nullptr){
+            position = this->plist->previousPosition(position);
+            this->pastEnd = true;
+        }
+    }
+    else{
+        if (hadPrevious)
+            position = this->plist->previousPosition(position);
+        else
+            this->pastStart = true;
+    }
+    this->current = position.node;
+    this->index = position.index;
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+UnrolledLinkedList<ValueType, NodeBytes>::StlIterator::StlIterator(
+    Node* node, unsigned int index, const UnrolledLinkedList* list) noexcept
+    : node{node}, index{index}, list{list}
+{
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+ValueType& UnrolledLinkedList<ValueType, NodeBytes>::StlIterator::operator*() const noexcept
+{
+    return node->at(index);
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+ValueType* UnrolledLinkedList<ValueType, NodeBytes>::StlIterator::operator->() const noexcept
+{
+    return &node->at(index);
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+typename UnrolledLinkedList<ValueType, NodeBytes>::StlIterator&
+UnrolledLinkedList<ValueType, NodeBytes>::StlIterator::operator++() noexcept
+{
+    Position position = list->nextPosition(Position{node, index});
+    node = position.node;
+    index = position.index;
+    return *this;
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+typename UnrolledLinkedList<ValueType, NodeBytes>::StlIterator
+UnrolledLinkedList<ValueType, NodeBytes>::StlIterator::operator++(int) noexcept
+{
+    StlIterator old = *this;
+    ++*this;
+    return old;
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+typename UnrolledLinkedList<ValueType, NodeBytes>::StlIterator&
+UnrolledLinkedList<ValueType, NodeBytes>::StlIterator::operator--() noexcept
+{
+    Position position = list->previousPosition(Position{node, index});
+    node = position.node;
+    index = position.index;
+    return *this;
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+typename UnrolledLinkedList<ValueType, NodeBytes>::StlIterator
+UnrolledLinkedList<ValueType, NodeBytes>::StlIterator::operator--(int) noexcept
+{
+    StlIterator old = *this;
+    --*this;
+    return old;
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+bool UnrolledLinkedList<ValueType, NodeBytes>::StlIterator::operator==(const StlIterator& other) const noexcept
+{
+    return node == other.node && index == other.index;
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+bool UnrolledLinkedList<ValueType, NodeBytes>::StlIterator::operator!=(const StlIterator& other) const noexcept
+{
+    return !(*this == other);
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+UnrolledLinkedList<ValueType, NodeBytes>::ConstStlIterator::ConstStlIterator(
+    const Node* node, unsigned int index, const UnrolledLinkedList* list) noexcept
+    : node{node}, index{index}, list{list}
+{
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+UnrolledLinkedList<ValueType, NodeBytes>::ConstStlIterator::ConstStlIterator(const StlIterator& iterator) noexcept
+    : node{iterator.node}, index{iterator.index}, list{iterator.list}
+{
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+const ValueType& UnrolledLinkedList<ValueType, NodeBytes>::ConstStlIterator::operator*() const noexcept
+{
+    return node->at(index);
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+const ValueType* UnrolledLinkedList<ValueType, NodeBytes>::ConstStlIterator::operator->() const noexcept
+{
+    return &node->at(index);
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+typename UnrolledLinkedList<ValueType, NodeBytes>::ConstStlIterator&
+UnrolledLinkedList<ValueType, NodeBytes>::ConstStlIterator::operator++() noexcept
+{
+    Position position = list->nextPosition(Position{const_cast<Node*>(node), index});
+    node = position.node;
+    index = position.index;
+    return *this;
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+typename UnrolledLinkedList<ValueType, NodeBytes>::ConstStlIterator
+UnrolledLinkedList<ValueType, NodeBytes>::ConstStlIterator::operator++(int) noexcept
+{
+    ConstStlIterator old = *this;
+    ++*this;
+    return old;
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+typename UnrolledLinkedList<ValueType, NodeBytes>::ConstStlIterator&
+UnrolledLinkedList<ValueType, NodeBytes>::ConstStlIterator::operator--() noexcept
+{
+    Position position = list->previousPosition(Position{const_cast<Node*>(node), index});
+    node = position.node;
+    index = position.index;
+    return *this;
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+typename UnrolledLinkedList<ValueType, NodeBytes>::ConstStlIterator
+UnrolledLinkedList<ValueType, NodeBytes>::ConstStlIterator::operator--(int) noexcept
+{
+    ConstStlIterator old = *this;
+    --*this;
+    return old;
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+bool UnrolledLinkedList<ValueType, NodeBytes>::ConstStlIterator::operator==(const ConstStlIterator& other) const noexcept
+{
+    return node == other.node && index == other.index;
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+bool UnrolledLinkedList<ValueType, NodeBytes>::ConstStlIterator::operator!=(const ConstStlIterator& other) const noexcept
+{
+    return !(*this == other);
+}
+
+
+// Allocates an empty node whose values will start at the given index and
+// links it in between prev and next, either of which can be nullptr.
+template <typename ValueType, unsigned int NodeBytes>
+typename UnrolledLinkedList<ValueType, NodeBytes>::Node* UnrolledLinkedList<ValueType, NodeBytes>::linkNewNode(
+    Node* prev, Node* next, unsigned short start)
+{
+    Node* node = new Node;
+    allocated(sizeof(Node));
+    node->start = start;
+    node->prev = prev;
+    node->next = next;
+
+    if (prev != nullptr)
+        prev->next = node;
+    else
+        head = node;
+
+    if (next != nullptr)
+        next->prev = node;
+    else
+        tail = node;
+
+    return node;
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+void UnrolledLinkedList<ValueType, NodeBytes>::unlinkNode(Node* node) noexcept
+{
+    if (node->prev != nullptr)
+        node->prev->next = node->next;
+    else
+        head = node->next;
+
+    if (node->next != nullptr)
+        node->next->prev = node->prev;
+    else
+        tail = node->prev;
+
+    freed(sizeof(Node));
+    delete node;
+}
+
+
+// Inserts a value so that it ends up before the value at the given
+// position (position.index can be position.node->count, meaning after the
+// last value in that node), and returns the position of the new value.
+// A full node is split in two first, except at either end of it, where a
+// new node is started instead.  Nothing is changed if allocation fails.
+template <typename ValueType, unsigned int NodeBytes>
+typename UnrolledLinkedList<ValueType, NodeBytes>::Position UnrolledLinkedList<ValueType, NodeBytes>::insertAt(
+    Position position, const ValueType& value)
+{
+    Node* node = position.node;
+    unsigned int index = position.index;
+
+    if (node->count == Capacity){
+        if (index == Capacity){
+            node = linkNewNode(node, node->next, 0);
+            index = 0;
+        }
+        else if (index == 0){
+            node = linkNewNode(node->prev, node, Capacity);
+        }
+        else{
+            Node* next = linkNewNode(node, node->next, 0);
+            unsigned int keep = Capacity / 2;
+            for (unsigned int i = keep; i < Capacity; i++)
+                next->values[i - keep] = node->at(i);
+            next->count = Capacity - keep;
+            node->count = keep;
+
+            if (index >= keep){
+                node = next;
+                index -= keep;
+            }
+        }
+    }
+
+    // Shift whichever side of the insertion point is shorter, if there's
+    // room on that side of the node.
+    bool roomAtFront = node->start > 0;
+    bool roomAtBack = static_cast<unsigned int>(node->start + node->count) < Capacity;
+    if (roomAtFront && (!roomAtBack || index < node->count - index)){
+        node->start--;
+        for (unsigned int i = 0; i < index; i++)
+            node->at(i) = node->at(i + 1);
+    }
+    else{
+        for (unsigned int i = node->count; i > index; i--)
+            node->at(i) = node->at(i - 1);
+    }
+
+    node->at(index) = value;
+    node->count++;
+    listSize++;
+    counted(listSize);
+    return Position{node, index};
+}
+
+
+// Removes the value at the given position and returns the position of the
+// value that followed it.  A node that is emptied is unlinked, and one
+// that ends up no more than half full together with a neighbour is merged
+// with it, so nodes stay reasonably full however values are removed.
+template <typename ValueType, unsigned int NodeBytes>
+typename UnrolledLinkedList<ValueType, NodeBytes>::Position UnrolledLinkedList<ValueType, NodeBytes>::removeAt(
+    Position position) noexcept
+{
+    Node* node = position.node;
+    unsigned int index = position.index;
+
+    if (index < node->count / 2){
+        for (unsigned int i = index; i > 0; i--)
+            node->at(i) = node->at(i - 1);
+        node->start++;
+    }
+    else{
+        for (unsigned int i = index; i + 1 < node->count; i++)
+            node->at(i) = node->at(i + 1);
+    }
+    node->count--;
+    listSize--;
+
+    if (node->count == 0){
+        Node* next = node->next;
+        unlinkNode(node);
+        return Position{next, 0};
+    }
+
+    Position next = index < node->count ? Position{node, index} : Position{node->next, 0};
+
+    if (node->next != nullptr && node->count + node->next->count <= Capacity / 2){
+        if (next.node == node->next)
+            next = Position{node, node->count + next.index};
+        mergeNext(node);
+    }
+    else if (node->prev != nullptr && node->prev->count + node->count <= Capacity / 2){
+        Node* prev = node->prev;
+        if (next.node == node)
+            next = Position{prev, prev->count + next.index};
+        mergeNext(prev);
+    }
+
+    return next;
+}
+
+
+// Moves the values in the node after the given one to the end of it and
+// unlinks the emptied node.
+template <typename ValueType, unsigned int NodeBytes>
+void UnrolledLinkedList<ValueType, NodeBytes>::mergeNext(Node* node) noexcept
+{
+    Node* next = node->next;
+
+    if (static_cast<unsigned int>(node->start + node->count + next->count) > Capacity){
+        for (unsigned int i = 0; i < node->count; i++)
+            node->values[i] = node->at(i);
+        node->start = 0;
+    }
+
+    for (unsigned int i = 0; i < next->count; i++)
+        node->at(node->count + i) = next->at(i);
+    node->count += next->count;
+    unlinkNode(next);
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+typename UnrolledLinkedList<ValueType, NodeBytes>::Position UnrolledLinkedList<ValueType, NodeBytes>::nextPosition(
+    Position position) const noexcept
+{
+    if (position.index + 1 < position.node->count)
+        return Position{position.node, position.index + 1};
+    else
+        return Position{position.node->next, 0};
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+typename UnrolledLinkedList<ValueType, NodeBytes>::Position UnrolledLinkedList<ValueType, NodeBytes>::previousPosition(
+    Position position) const noexcept
+{
+    if (position.node == nullptr)
+        return Position{tail, tail->count - 1u};
+    else if (position.index > 0)
+        return Position{position.node, position.index - 1};
+    else
+        return Position{position.node->prev, position.node->prev->count - 1u};
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+void UnrolledLinkedList<ValueType, NodeBytes>::deleteList() noexcept
+{
+    while (head != nullptr){
+        Node* next = head->next;
+        freed(sizeof(Node));
+        delete head;
+        head = next;
+    }
+    tail = nullptr;
+    listSize = 0;
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+void UnrolledLinkedList<ValueType, NodeBytes>::copyList(const UnrolledLinkedList& list)
+{
+    try{
+        for (const ValueType& value : list)
+            addToEnd(value);
+    }catch(...){
+        deleteList();
+        throw;
+    }
+}
+
+
+template <typename ValueType, unsigned int NodeBytes>
+void UnrolledLinkedList<ValueType, NodeBytes>::swap(UnrolledLinkedList& list) noexcept
+{
+    std::swap(head, list.head);
+    std::swap(tail, list.tail);
+    std::swap(listSize, list.listSize);
+    swapAccount(list);
+}
+
+
+
+#endif
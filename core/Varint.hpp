@@ -0,0 +1,74 @@
+// Varint.hpp
+
+#ifndef VARINT_HPP
+#define VARINT_HPP
+
+#include <streambuf>
+
+
+
+// Varints store an unsigned integer in as few bytes as it needs, 7 bits
+// per byte starting with the lowest, with the top bit of every byte but
+// the last set.  Numbers under 128 take a single byte.  Signed numbers are
+// zigzag encoded first (0, -1, 1, -2, ... become 0, 1, 2, 3, ...) so that
+// small negative numbers stay small too.  Both work on a streambuf rather
+// than a stream, to skip the stream's per-call overhead.
+
+
+// zigzagEncode() maps a signed number onto an unsigned one, small
+// magnitudes to small numbers; zigzagDecode() maps it back.
+unsigned long long zigzagEncode(long long value) noexcept;
+long long zigzagDecode(unsigned long long value) noexcept;
+
+
+// writeVarint() writes value as a varint, returning false if the buffer
+// couldn't take all of it.
+bool writeVarint(std::streambuf& out, unsigned long long value);
+
+
+// readVarint() reads a varint into value and returns true, or returns false
+// if the buffer ran out first or the varint is too long for 64 bits.
+bool readVarint(std::streambuf& in, unsigned long long& value);
+
+
+
+inline unsigned long long zigzagEncode(long long value) noexcept
+{
+    return (static_cast<unsigned long long>(value) << 1) ^ static_cast<unsigned long long>(value >> 63);
+}
+
+
+inline long long zigzagDecode(unsigned long long value) noexcept
+{
+    return static_cast<long long>(value >> 1) ^ -static_cast<long long>(value & 1);
+}
+
+
+inline bool writeVarint(std::streambuf& out, unsigned long long value)
+{
+    while (value >= 0x80){
+        if (out.sputc(static_cast<char>((value & 0x7f) | 0x80)) == std::streambuf::traits_type::eof())
+            return false;
+        value >>= 7;
+    }
+    return out.sputc(static_cast<char>(value)) != std::streambuf::traits_type::eof();
+}
+
+
+inline bool readVarint(std::streambuf& in, unsigned long long& value)
+{
+    value = 0;
+    for (unsigned int shift = 0; shift < 64; shift += 7){
+        std::streambuf::int_type byte = in.sbumpc();
+        if (byte == std::streambuf::traits_type::eof())
+            return false;
+        value |= static_cast<unsigned long long>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0)
+            return true;
+    }
+    return false;
+}
+
+
+
+#endif
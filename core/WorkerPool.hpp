@@ -0,0 +1,127 @@
+// WorkerPool.hpp
+
+#ifndef WORKERPOOL_HPP
+#define WORKERPOOL_HPP
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+
+// WorkerPool keeps a fixed number of threads around so that the same kind
+// of work can be split between them over and over again without starting
+// new threads each time.  run() hands a task to every worker and waits for
+// all of them to finish it; the calling thread acts as worker 0, so a pool
+// of n workers starts n - 1 threads.  Everything a task wrote is visible to
+// the caller once run() returns, and everything the caller wrote before
+// calling run() is visible to the task.
+class WorkerPool
+{
+public:
+    // Initializes this pool with the given number of workers (at least 1).
+    explicit WorkerPool(unsigned int workers);
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+
+    // Stops and joins the pool's threads.
+    ~WorkerPool() noexcept;
+
+
+    // run() calls task(w) once for every worker w, in parallel, and
+    // returns once all of the calls have returned.  The task must not
+    // throw.
+    void run(const std::function<void(unsigned int)>& task);
+
+
+    // size() returns the number of workers.
+    unsigned int size() const noexcept;
+
+
+private:
+    void work(unsigned int worker);
+
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable started;
+    std::condition_variable finished;
+    const std::function<void(unsigned int)>* current = nullptr;
+    unsigned long long round = 0;
+    unsigned int running = 0;
+    bool stopping = false;
+};
+
+
+
+inline WorkerPool::WorkerPool(unsigned int workers)
+{
+    for (unsigned int w = 1; w < workers; w++)
+        threads.emplace_back(&WorkerPool::work, this, w);
+}
+
+
+inline WorkerPool::~WorkerPool() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        stopping = true;
+    }
+    started.notify_all();
+    for (std::thread& thread : threads)
+        thread.join();
+}
+
+
+inline void WorkerPool::run(const std::function<void(unsigned int)>& task)
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        current = &task;
+        running = threads.size();
+        round++;
+    }
+    started.notify_all();
+
+    task(0);
+
+    std::unique_lock<std::mutex> lock{mutex};
+    finished.wait(lock, [this]{ return running == 0; });
+    current = nullptr;
+}
+
+
+inline unsigned int WorkerPool::size() const noexcept
+{
+    return threads.size() + 1;
+}
+
+
+inline void WorkerPool::work(unsigned int worker)
+{
+    unsigned long long seen = 0;
+    while (true){
+        const std::function<void(unsigned int)>* task;
+        {
+            std::unique_lock<std::mutex> lock{mutex};
+            started.wait(lock, [&]{ return stopping || round != seen; });
+            if (stopping)
+                return;
+            seen = round;
+            task = current;
+        }
+
+        (*task)(worker);
+
+        std::lock_guard<std::mutex> lock{mutex};
+        if (--running == 0)
+            finished.notify_one();
+    }
+}
+
+
+
+#endif
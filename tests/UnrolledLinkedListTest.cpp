@@ -0,0 +1,208 @@
+// UnrolledLinkedListTest.cpp
+//
+// Checks the middle-of-the-list paths of UnrolledLinkedList's Iterator:
+// insertBefore() and insertAfter() splitting a full node, and remove()
+// merging a node with its neighbor.  Every list is checked against a
+// DoublyLinkedList that had the same things done to it, since the two are
+// meant to behave exactly the same way.
+
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "DoublyLinkedList.hpp"
+#include "UnrolledLinkedList.hpp"
+
+#define CHECK(condition) check((condition), #condition, __LINE__)
+
+namespace
+{
+    int failures = 0;
+
+    void check(bool passed, const char* what, int line)
+    {
+        if (!passed){
+            std::cerr << "UnrolledLinkedListTest.cpp:" << line << ": failed: " << what << std::endl;
+            failures++;
+        }
+    }
+
+
+    // Returns a list's values, walking it forward with a ConstIterator and
+    // checking that walking it backward finds them in reverse
+    template <typename List>
+    std::vector<int> valuesOf(const List& list)
+    {
+        std::vector<int> values;
+        for (typename List::ConstIterator it = list.constIterator(); !it.isPastEnd(); it.moveToNext())
+            values.push_back(it.value());
+
+        std::vector<int> backward;
+        for (auto it = list.end(); it != list.begin(); )
+            backward.push_back(*--it);
+        CHECK(std::vector<int>(backward.rbegin(), backward.rend()) == values);
+        CHECK(values.size() == list.size());
+        return values;
+    }
+
+
+    // An UnrolledLinkedList and a DoublyLinkedList, each with an Iterator,
+    // that every step is done to alike
+    template <unsigned int NodeBytes>
+    struct Pair
+    {
+        UnrolledLinkedList<int, NodeBytes> unrolled;
+        DoublyLinkedList<int> expected;
+        typename UnrolledLinkedList<int, NodeBytes>::Iterator unrolledIt = unrolled.iterator();
+        typename DoublyLinkedList<int>::Iterator expectedIt = expected.iterator();
+
+        void fill(int count)
+        {
+            for (int i = 0; i < count; i++){
+                unrolled.addToEnd(i);
+                expected.addToEnd(i);
+            }
+            restart();
+        }
+
+        void restart()
+        {
+            unrolledIt = unrolled.iterator();
+            expectedIt = expected.iterator();
+        }
+
+        void moveTo(int index)
+        {
+            restart();
+            for (int i = 0; i < index; i++){
+                unrolledIt.moveToNext();
+                expectedIt.moveToNext();
+            }
+        }
+
+        // Does step to both iterators, checking that either both or
+        // neither of them throw, and that they end up in the same place
+        template <typename Step>
+        void apply(Step step)
+        {
+            bool unrolledThrew = false, expectedThrew = false;
+            try { step(unrolledIt); } catch (IteratorException&) { unrolledThrew = true; }
+            try { step(expectedIt); } catch (IteratorException&) { expectedThrew = true; }
+            CHECK(unrolledThrew == expectedThrew);
+            CHECK(unrolledIt.isPastStart() == expectedIt.isPastStart());
+            CHECK(unrolledIt.isPastEnd() == expectedIt.isPastEnd());
+            if (!expectedIt.isPastStart() && !expectedIt.isPastEnd())
+                CHECK(unrolledIt.value() == expectedIt.value());
+        }
+
+        void compare()
+        {
+            CHECK(valuesOf(unrolled) == valuesOf(expected));
+        }
+    };
+
+
+    // Inserting in the middle of full nodes splits them, whichever side of
+    // the iterator the value goes on and wherever in the node it is
+    void testSplits()
+    {
+        for (int at = 0; at < 40; at++){
+            Pair<64> before;
+            before.fill(40);
+            before.moveTo(at);
+            for (int i = 0; i < 30; i++){
+                before.apply([i](auto& it){ it.insertBefore(1000 + i); });
+                before.compare();
+            }
+
+            Pair<64> after;
+            after.fill(40);
+            after.moveTo(at);
+            for (int i = 0; i < 30; i++){
+                after.apply([i](auto& it){ it.insertAfter(1000 + i); });
+                after.compare();
+            }
+        }
+    }
+
+
+    // Removing values from the middle drains nodes until they merge with
+    // a neighbor, moving the iterator either way afterward
+    void testMerges()
+    {
+        for (int at = 0; at < 60; at++){
+            for (bool moveToNext : {true, false}){
+                Pair<64> pair;
+                pair.fill(60);
+                pair.moveTo(at);
+                while (pair.expected.size() > 0){
+                    if (pair.expectedIt.isPastEnd() || pair.expectedIt.isPastStart())
+                        pair.moveTo(pair.expected.size() / 2);
+                    pair.apply([moveToNext](auto& it){ it.remove(moveToNext); });
+                    pair.compare();
+                }
+            }
+        }
+    }
+
+
+    // Random walks that move the iterator around and insert and remove
+    // wherever it is, with nodes of a few different sizes
+    template <unsigned int NodeBytes>
+    void testRandomSteps(unsigned int seed)
+    {
+        std::mt19937 random(seed);
+        Pair<NodeBytes> pair;
+        pair.fill(100);
+
+        for (int step = 0; step < 20000; step++){
+            int value = random() % 1000;
+            switch (random() % 6){
+            case 0:
+                pair.apply([](auto& it){ it.moveToNext(); });
+                break;
+            case 1:
+                pair.apply([](auto& it){ it.moveToPrevious(); });
+                break;
+            case 2:
+                pair.apply([value](auto& it){ it.insertBefore(value); });
+                break;
+            case 3:
+                pair.apply([value](auto& it){ it.insertAfter(value); });
+                break;
+            case 4:
+                pair.apply([](auto& it){ it.remove(true); });
+                break;
+            case 5:
+                pair.apply([](auto& it){ it.remove(false); });
+                break;
+            }
+            if (pair.expected.isEmpty())
+                pair.fill(10);
+            else if (pair.expectedIt.isPastStart() || pair.expectedIt.isPastEnd())
+                pair.moveTo(pair.expected.size() / 2);
+            if (step % 97 == 0)
+                pair.compare();
+        }
+        pair.compare();
+    }
+}
+
+
+int main()
+{
+    testSplits();
+    testMerges();
+    for (unsigned int seed = 1; seed <= 5; seed++){
+        testRandomSteps<64>(seed);
+        testRandomSteps<32>(seed);
+        testRandomSteps<128>(seed);
+    }
+
+    if (failures > 0){
+        std::cerr << failures << " checks failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "UnrolledLinkedListTest: all checks passed" << std::endl;
+    return EXIT_SUCCESS;
+}